@@ -0,0 +1,310 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Jobs.hxx>
+#include <Core.Diagnostics/Trace.hxx>
+#include <Core.Diagnostics/Debug.hxx>
+#include <Core.World/Physics.hxx>
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//
+// Game definition.
+//
+#include <Game.hxx>
+
+namespace
+{
+    struct HeadlessOptions final
+    {
+        //
+        // Simulated time in seconds.
+        //
+        float Duration = 60.0F;
+
+        //
+        // Meteorites per second; zero means that spawn rate follows difficulty.
+        //
+        float SpawnRate = 0.0F;
+
+        //
+        // Fixed frame time fed to game.
+        //
+        float DeltaTime = 1.0F / 60.0F;
+
+        uint32_t Seed = 5489U;
+        uint32_t Workers = 0;
+        Core::World::PhysicsBackend Backend = Core::World::PhysicsBackend::PhysX;
+        GameProject::LaserBulletMode BulletMode = GameProject::LaserBulletMode::RigidBody;
+
+        //
+        // Session file written after run or replayed instead of generated frames.
+        //
+        const char* RecordPath = nullptr;
+        const char* ReplayPath = nullptr;
+    };
+
+    void PrintUsage(const char* program) noexcept
+    {
+        std::fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --duration <seconds>     simulated time (default: 60)\n"
+            "  --spawn-rate <per sec>   constant meteorite spawn rate (default: difficulty based)\n"
+            "  --seed <number>          random seed (default: 5489)\n"
+            "  --step <seconds>         fixed frame time (default: 1/60)\n"
+            "  --workers <count>        job system workers (default: hardware threads)\n"
+            "  --physics <backend>      physx or planar (default: physx)\n"
+            "  --bullets <mode>         rigid or hitscan (default: rigid)\n"
+            "  --record <path>          save session recording\n"
+            "  --replay <path>          replay session recording; other simulation options are ignored\n",
+            program
+        );
+    }
+
+    bool ParseOptions(int argc, char** argv, HeadlessOptions& options) noexcept
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* name = argv[i];
+
+            if (i + 1 >= argc)
+            {
+                return false;
+            }
+
+            const char* value = argv[++i];
+
+            if (std::strcmp(name, "--duration") == 0)
+            {
+                options.Duration = std::strtof(value, nullptr);
+            }
+            else if (std::strcmp(name, "--spawn-rate") == 0)
+            {
+                options.SpawnRate = std::strtof(value, nullptr);
+            }
+            else if (std::strcmp(name, "--seed") == 0)
+            {
+                options.Seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            }
+            else if (std::strcmp(name, "--step") == 0)
+            {
+                options.DeltaTime = std::strtof(value, nullptr);
+            }
+            else if (std::strcmp(name, "--workers") == 0)
+            {
+                options.Workers = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            }
+            else if (std::strcmp(name, "--physics") == 0)
+            {
+                if (std::strcmp(value, "physx") == 0)
+                {
+                    options.Backend = Core::World::PhysicsBackend::PhysX;
+                }
+                else if (std::strcmp(value, "planar") == 0)
+                {
+                    options.Backend = Core::World::PhysicsBackend::Planar;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            else if (std::strcmp(name, "--bullets") == 0)
+            {
+                if (std::strcmp(value, "rigid") == 0)
+                {
+                    options.BulletMode = GameProject::LaserBulletMode::RigidBody;
+                }
+                else if (std::strcmp(value, "hitscan") == 0)
+                {
+                    options.BulletMode = GameProject::LaserBulletMode::Hitscan;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            else if (std::strcmp(name, "--record") == 0)
+            {
+                options.RecordPath = value;
+            }
+            else if (std::strcmp(name, "--replay") == 0)
+            {
+                options.ReplayPath = value;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return options.Duration > 0.0F && options.DeltaTime > 0.0F && options.SpawnRate >= 0.0F;
+    }
+
+    //
+    // FNV-1a over simulated state. Equal hashes of two runs mean that they ended bit-for-bit equal.
+    //
+    uint64_t HashState(const Core::World::ComponentStorage& components) noexcept
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+
+        auto combine = [&hash](const void* data, size_t size)
+        {
+            auto bytes = static_cast<const uint8_t*>(data);
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3ULL;
+            }
+        };
+
+        for (size_t i = 0; i < components.Positions.size(); ++i)
+        {
+            combine(&components.Types[i], sizeof(components.Types[i]));
+            combine(&components.Positions[i], sizeof(float) * 3);
+            combine(&components.Orientations[i], sizeof(float) * 4);
+        }
+
+        return hash;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    HeadlessOptions options{};
+
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    //
+    // Initialize diagnostics.
+    //
+    Core::Diagnostics::Debug::Initialize();
+    Core::Diagnostics::Trace::Initialize();
+
+    GameProject::InputRecordingRef replay{};
+
+    if (options.ReplayPath != nullptr)
+    {
+        replay = GameProject::InputRecording::Load(options.ReplayPath);
+
+        if (replay == nullptr)
+        {
+            Core::Diagnostics::Trace::Shutdown();
+            Core::Diagnostics::Debug::Shutdown();
+            return EXIT_FAILURE;
+        }
+    }
+
+    //
+    // Start job system. Physics runs its tasks on it.
+    //
+    Core::Jobs::Initialize(options.Workers);
+
+    //
+    // Initialize physics.
+    //
+    Core::World::Physics::Initialize();
+    {
+        auto game = Core::MakeRef<GameProject::Game>();
+
+        if (replay != nullptr)
+        {
+            game->BeginReplay(replay);
+        }
+        else
+        {
+            game->SetSeed(options.Seed);
+            game->SetSpawnRate(options.SpawnRate);
+            game->SetPhysicsBackend(options.Backend);
+            game->SetBulletMode(options.BulletMode);
+
+            if (options.RecordPath != nullptr)
+            {
+                game->BeginRecording();
+            }
+        }
+
+        game->Initialize();
+
+        //
+        // Fixed step clock: every run of given options simulates exactly the same frames, no matter
+        // how fast machine is. Replays use recorded frame times instead.
+        //
+        const auto frames = (replay != nullptr)
+            ? static_cast<uint64_t>(replay->GetFrameCount())
+            : static_cast<uint64_t>(options.Duration / options.DeltaTime);
+
+        using Clock = std::chrono::steady_clock;
+
+        double totalTime = 0.0;
+        double maxFrameTime = 0.0;
+        size_t maxObjects = 0;
+
+        for (uint64_t frame = 0; frame < frames; ++frame)
+        {
+            const auto start = Clock::now();
+
+            game->Tick(options.DeltaTime);
+
+            const auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+            totalTime += elapsed;
+            maxFrameTime = (std::max)(maxFrameTime, elapsed);
+            maxObjects = (std::max)(maxObjects, game->GetScene()->GetObjectsCount());
+        }
+
+        //
+        // Let last step finish, so hash covers all simulated frames.
+        //
+        game->GetScene()->FetchResults();
+
+        //
+        // Single line summary, easy to scrape by CI.
+        //
+        std::printf("frames=%" PRIu64 " wall=%.3f avg_ms=%.4f max_ms=%.4f max_objects=%zu state=%016" PRIx64 "\n",
+            frames,
+            totalTime,
+            (frames > 0) ? (totalTime * 1000.0 / static_cast<double>(frames)) : 0.0,
+            maxFrameTime * 1000.0,
+            maxObjects,
+            HashState(game->GetScene()->GetComponents())
+        );
+
+        if (options.RecordPath != nullptr && replay == nullptr)
+        {
+            game->GetRecording()->Save(options.RecordPath);
+        }
+
+        game->Shutdown();
+    }
+
+    //
+    // Shutdown physics.
+    //
+    Core::World::Physics::Shutdown();
+
+    //
+    // Stop worker threads.
+    //
+    Core::Jobs::Shutdown();
+
+    //
+    // And diagnostics.
+    //
+    Core::Diagnostics::Trace::Shutdown();
+    Core::Diagnostics::Debug::Shutdown();
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
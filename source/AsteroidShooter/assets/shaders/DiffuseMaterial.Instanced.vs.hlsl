@@ -0,0 +1,93 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+//
+// Camera data.
+//
+cbuffer CameraData : register(b0)
+{
+    float4x4 CameraData_View;
+    float4x4 CameraData_Projection;
+};
+
+//
+// Input and output.
+//
+// World matrix rows of each instance are streamed from second vertex buffer.
+//
+struct VS_INPUT
+{
+    float3 Position : SV_Position;
+    float3 Normal : NORMAL;
+    float2 TexCoord : TEXCOORD;
+    float4 World0 : WORLD0;
+    float4 World1 : WORLD1;
+    float4 World2 : WORLD2;
+    float4 World3 : WORLD3;
+};
+
+struct VS_OUTPUT
+{
+    float4 Position : SV_Position;
+    float2 TexCoord : TEXCOORD0;
+    float3 Normal : NORMAL;
+    float4 Color : COLOR;
+};
+
+//
+// Some predefined lighting.
+//
+static const float3 DiffuseLightDirection = normalize(float3(1.0F, 0.5F, -1.0F));
+static const float4 DiffuseColor = float4(1, 1, 1, 1);
+static const float DiffuseIntensity = 1.0;
+
+VS_OUTPUT main(VS_INPUT input)
+{
+    //
+    // Expand position to homogenous space.
+    //
+    float4 position = float4(input.Position, 1.0F);
+    
+    //
+    // Rows are stored as on CPU side; transpose them to match layout of matrices read from
+    // constant buffers.
+    //
+    float4x4 world = transpose(float4x4(input.World0, input.World1, input.World2, input.World3));
+
+    //
+    // Compute WV + WVP matrices.
+    //
+    float4x4 worldView = mul(CameraData_View, world);
+    float4x4 worldViewProjection = mul(CameraData_Projection, worldView);
+
+    //
+    // Transform positon.
+    //
+    position = mul(worldViewProjection, position);
+
+    //
+    // Pass that position and texcoord to PS.
+    //
+    VS_OUTPUT output;
+    output.Position = position;
+    output.TexCoord = input.TexCoord;
+
+    //
+    // Compute normal from local space to world space.
+    //
+    output.Normal = mul((float3x3)world, input.Normal);
+
+    //
+    // Compute light intensity based on normal and light direction.
+    //
+    float lightIntensity = dot(output.Normal, DiffuseLightDirection);
+
+    //
+    // And saturate that by diffuse color and light intensity. Just per vertex lighting.
+    //
+    output.Color = saturate(DiffuseColor * DiffuseIntensity * lightIntensity);
+    return output;
+}
\ No newline at end of file
@@ -16,7 +16,7 @@ cbuffer CameraData : register(b0)
 //
 // Object data.
 //
-// Good candidate for instancing too.
+// Used only for objects drawn one by one; see DiffuseMaterial.Instanced.vs.hlsl.
 //
 cbuffer ObjectData : register(b1)
 {
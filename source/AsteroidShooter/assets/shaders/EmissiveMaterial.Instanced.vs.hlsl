@@ -0,0 +1,80 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+//
+// Emmisive Material, instanced variant.
+//
+// Fake. Just outputs vertex position & texture coords to PS :)
+//
+
+
+//
+// Camera data. Holds view & projection matrices.
+//
+cbuffer CameraData : register(b0)
+{
+    float4x4 CameraData_View;
+    float4x4 CameraData_Projection;
+};
+
+//
+// Common vertex input, with world matrix rows of each instance.
+//
+struct VS_INPUT
+{
+    float3 Position : SV_Position;
+    float3 Normal : NORMAL;
+    float2 TexCoord : TEXCOORD;
+    float4 World0 : WORLD0;
+    float4 World1 : WORLD1;
+    float4 World2 : WORLD2;
+    float4 World3 : WORLD3;
+};
+
+//
+// Common vertex outpu :)
+//
+struct VS_OUTPUT
+{
+    float4 Position : SV_Position;
+    float2 TexCoord : TEXCOORD0;
+};
+
+VS_OUTPUT main(VS_INPUT input)
+{
+    //
+    // Expand position to homogenous space.
+    //
+    float4 position = float4(input.Position, 1.0F);
+    
+    //
+    // Rebuild world transform of instance, in the same layout as constant buffer matrices.
+    //
+    float4x4 world = transpose(float4x4(input.World0, input.World1, input.World2, input.World3));
+
+    //
+    // Compute WV transform.
+    //
+    float4x4 worldView = mul(CameraData_View, world);
+
+    //
+    // And final WVP transform.
+    //
+    float4x4 worldViewProjection = mul(CameraData_Projection, worldView);
+
+    //
+    // And transformed vertex position.
+    //
+    position = mul(worldViewProjection, position);
+
+    //
+    // Move forward position and texcoord.
+    //
+    VS_OUTPUT output;
+    output.Position = position;
+    output.TexCoord = input.TexCoord;
+    return output;
+}
\ No newline at end of file
@@ -24,8 +24,8 @@ cbuffer CameraData : register(b0)
 // Object data. Precomputed for each rendered object before actual drawcall.
 //
 // Note:
-//      It may also use instancing to render them in single drawcall, but that
-//      kind of optimizations aren't part of that test :)
+//      Scene renders objects in single drawcall per mesh and material with
+//      EmissiveMaterial.Instanced.vs.hlsl; this one is fallback path.
 //
 //      This is really a balance between more ops on GPU (matrix multiplication)
 //      and memory usage and drawcalls.
@@ -8,20 +8,24 @@
 //
 
 #include <Core/CoreEventHandler.hxx>
-#include <Core/CoreWindow.hxx>
 #include <Core.World/Scene.hxx>
 #include <Core.World/Physics.hxx>
+#if !defined(CORE_HEADLESS)
+#include <Core/CoreWindow.hxx>
 #include <Core.Rendering/CommandList.hxx>
 #include <Core.Rendering/RenderSystem.hxx>
+#endif
 
 #include <Core.Rendering/MaterialRenderer.hxx>
 #include <Core.Rendering/MeshRenderer.hxx>
+#if !defined(CORE_HEADLESS)
 #include <Core.World/Camera.hxx>
+#endif
 
 #include <SpaceShip.hxx>
 #include <Meteorite.hxx>
-
-#include <random>
+#include <InputRecording.hxx>
+#include <MeteoriteSpawner.hxx>
 
 namespace GameProject
 {
@@ -33,11 +37,18 @@ namespace GameProject
         static Game* Current;
 
     private:
+#if !defined(CORE_HEADLESS)
         CoreWindowRef m_Window;
         Rendering::ViewportRef m_Viewport;
+        Rendering::OcclusionQueryRef m_Query;
+
+        //
+        // Command list counters of last rendered frame.
+        //
+        Rendering::CommandListStatistics m_RenderStatistics{};
+#endif
 
         World::SceneRef m_Scene;
-        Rendering::OcclusionQueryRef m_Query;
 
         Rendering::MaterialRendererRef m_SpaceShipMaterial;
         Rendering::MeshRendererRef m_SpaceShipMesh;
@@ -50,6 +61,12 @@ namespace GameProject
 
         SpaceShipRef m_SpaceShip;
 
+        //
+        // Bullets and meteorites are recycled together with their physics actors.
+        //
+        LaserBulletPoolRef m_BulletPool;
+        MeteoritePoolRef m_MeteoritePool;
+
         float m_MoveLeftVelocity;
         float m_MoveRightVelocity;
 
@@ -60,7 +77,7 @@ namespace GameProject
         static constexpr const auto VisibleRangeExtent = 20.0F;
 
     private:
-        std::mt19937 m_RandomEngine;
+        MeteoriteSpawner m_Spawner;
         float m_SpawnTimeout;
         float m_SpawnInterval;
         uint32_t m_FrameCount;
@@ -68,10 +85,26 @@ namespace GameProject
         bool m_IsRestarting;
         uint32_t m_MeteoritesShotDown;
 
+        //
+        // Spawn interval forced from outside; zero means that it follows difficulty.
+        //
+        float m_FixedSpawnInterval;
+        float m_SpawnRate;
+        uint32_t m_Seed;
+        World::PhysicsBackend m_PhysicsBackend;
+        LaserBulletMode m_BulletMode;
+
+        //
+        // Session being recorded or replayed, if any.
+        //
+        InputRecordingRef m_Recording;
+        std::unique_ptr<InputReplay> m_Replay;
+
     public:
         Game() noexcept;
         virtual ~Game() noexcept;
 
+#if !defined(CORE_HEADLESS)
     public:
         virtual void OnWindowClose(CoreWindow* window) noexcept override final;
         virtual bool OnKeyDown(uint32_t keyCode, char32_t character, bool isRepeat) noexcept override final;
@@ -82,33 +115,86 @@ namespace GameProject
         virtual bool OnApplicationActivated(bool isActive) noexcept override final;
         virtual bool OnWindowEnterSizeMove(CoreWindow* window) noexcept override final;
         virtual void OnWindowExitSizeMove(CoreWindow* window) noexcept override final;
+#endif
 
+    public:
         virtual void Tick(float deltaTime) noexcept;
+#if !defined(CORE_HEADLESS)
         virtual void Render(float deltaTime) noexcept;
+#endif
 
     public:
         void Restart() noexcept;
         void NotifyMeteoriteShotDown() noexcept;
 
+        //
+        // Reseeds random engine used by spawner.
+        //
+        void SetSeed(uint32_t seed) noexcept;
+
+        //
+        // Forces constant spawn rate in meteorites per second. Zero restores difficulty based rate.
+        //
+        void SetSpawnRate(float rate) noexcept;
+
+        //
+        // Selects physics backend of scenes created on restart.
+        //
+        void SetPhysicsBackend(World::PhysicsBackend backend) noexcept
+        {
+            m_PhysicsBackend = backend;
+        }
+
+        //
+        // Selects how bullets fired after restart detect hits.
+        //
+        void SetBulletMode(LaserBulletMode mode) noexcept
+        {
+            m_BulletMode = mode;
+        }
+
+        //
+        // Player input. Ignored while replaying.
+        //
+        void HandleInput(GameInput input, bool isPressed) noexcept;
+
+        //
+        // Records whole session. Must be called before Initialize.
+        //
+        void BeginRecording() noexcept;
+
+        const InputRecordingRef& GetRecording() const noexcept
+        {
+            return m_Recording;
+        }
+
+        //
+        // Replays recorded session; recorded frame times override ones passed to Tick. Must be
+        // called before Initialize.
+        //
+        void BeginReplay(const InputRecordingRef& recording) noexcept;
+
+        bool IsReplayFinished() const noexcept
+        {
+            return m_Replay != nullptr && m_Replay->IsFinished();
+        }
+
+        const World::SceneRef& GetScene() const noexcept
+        {
+            return m_Scene;
+        }
+
     private:
         void DoRestart() noexcept;
         void RecomputeInterval() noexcept;
+        void ApplyInput(GameInput input, bool isPressed) noexcept;
 
     public:
         virtual void Initialize() noexcept;
         virtual void Shutdown() noexcept;
 
     private:
-        DirectX::XMVECTOR XM_CALLCONV RandomVector2D() noexcept;
-        DirectX::XMVECTOR XM_CALLCONV RandomVector3D() noexcept;
-        DirectX::XMVECTOR XM_CALLCONV RandomVector3D(DirectX::FXMVECTOR min, DirectX::FXMVECTOR max) noexcept;
-        DirectX::XMVECTOR XM_CALLCONV RandomUnitVector() noexcept;
-        DirectX::XMVECTOR XM_CALLCONV RandomQuaternion() noexcept;
-        DirectX::XMVECTOR XM_CALLCONV RandomAngularVelocity(float max) noexcept;
-
-        float RandomScalar(float min, float max) noexcept;
-
-        void SpawnMeteorite() noexcept;
+        void SpawnMeteorites(size_t count) noexcept;
     };
 }
 #endif // INCLUDED_GAME_HXX
\ No newline at end of file
@@ -0,0 +1,168 @@
+#ifndef INCLUDED_GAME_INPUTRECORDING_HXX
+#define INCLUDED_GAME_INPUTRECORDING_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+#include <Core/Reference.hxx>
+#include <Core.World/Common.hxx>
+#include <LaserBullet.hxx>
+
+namespace GameProject
+{
+    using namespace Core;
+
+    //
+    // Player actions, independent of keys they are bound to.
+    //
+    enum class GameInput : uint8_t
+    {
+        MoveLeft,
+        MoveRight,
+        Fire,
+    };
+
+    //
+    // Recorded gameplay session.
+    //
+    // Game is deterministic for given seed, spawn rate, physics backend, bullet mode, frame times
+    // and input applied at frame boundaries, so that is all what needs to be stored to re-run
+    // session bit-for-bit on the same build.
+    //
+    using InputRecordingRef = Reference<class InputRecording>;
+    class InputRecording final : public Object
+    {
+    public:
+        //
+        // Frame time used from given frame until next entry.
+        //
+        struct FrameTime
+        {
+            uint32_t Frame;
+            float DeltaTime;
+        };
+
+        //
+        // Input applied before given frame is simulated.
+        //
+        struct InputEvent
+        {
+            uint32_t Frame;
+            GameInput Input;
+            bool IsPressed;
+        };
+
+    private:
+        uint32_t m_Seed;
+        float m_SpawnRate;
+        World::PhysicsBackend m_Backend;
+        LaserBulletMode m_BulletMode;
+        uint32_t m_FrameCount;
+        std::vector<FrameTime> m_FrameTimes;
+        std::vector<InputEvent> m_Events;
+
+    public:
+        InputRecording(uint32_t seed, float spawnRate, World::PhysicsBackend backend, LaserBulletMode bulletMode) noexcept;
+        virtual ~InputRecording() noexcept;
+
+    public:
+        //
+        // Loads recording from file. Returns nullptr when file is missing or malformed.
+        //
+        static InputRecordingRef Load(const char* path) noexcept;
+        bool Save(const char* path) const noexcept;
+
+    public:
+        //
+        // Appends next frame. Frame time is stored only when it changes, so fixed step sessions
+        // take single entry.
+        //
+        void RecordFrame(float deltaTime) noexcept;
+        void RecordInput(GameInput input, bool isPressed) noexcept;
+
+    public:
+        uint32_t GetSeed() const noexcept
+        {
+            return m_Seed;
+        }
+
+        float GetSpawnRate() const noexcept
+        {
+            return m_SpawnRate;
+        }
+
+        World::PhysicsBackend GetBackend() const noexcept
+        {
+            return m_Backend;
+        }
+
+        LaserBulletMode GetBulletMode() const noexcept
+        {
+            return m_BulletMode;
+        }
+
+        uint32_t GetFrameCount() const noexcept
+        {
+            return m_FrameCount;
+        }
+
+        const std::vector<FrameTime>& GetFrameTimes() const noexcept
+        {
+            return m_FrameTimes;
+        }
+
+        const std::vector<InputEvent>& GetEvents() const noexcept
+        {
+            return m_Events;
+        }
+    };
+
+    //
+    // Walks recording frame by frame.
+    //
+    class InputReplay final
+    {
+    private:
+        InputRecordingRef m_Recording;
+        uint32_t m_Frame;
+        size_t m_NextFrameTime;
+        size_t m_NextEvent;
+        float m_DeltaTime;
+
+    public:
+        explicit InputReplay(const InputRecordingRef& recording) noexcept;
+
+    public:
+        bool IsFinished() const noexcept
+        {
+            return m_Frame >= m_Recording->GetFrameCount();
+        }
+
+        //
+        // Frame time of next frame.
+        //
+        float GetDeltaTime() noexcept;
+
+        //
+        // Calls function(GameInput, bool) for all events of next frame and advances to following one.
+        //
+        template <typename TFunction>
+        void Advance(TFunction&& function) noexcept
+        {
+            const auto& events = m_Recording->GetEvents();
+
+            for (; m_NextEvent < events.size() && events[m_NextEvent].Frame == m_Frame; ++m_NextEvent)
+            {
+                function(events[m_NextEvent].Input, events[m_NextEvent].IsPressed);
+            }
+
+            ++m_Frame;
+        }
+    };
+}
+
+#endif // INCLUDED_GAME_INPUTRECORDING_HXX
\ No newline at end of file
@@ -8,6 +8,7 @@
 //
 
 #include <Core.World/GameObject.hxx>
+#include <Core.World/GameObjectPool.hxx>
 #include <Core.Rendering/MaterialRenderer.hxx>
 #include <Core.Rendering/MeshRenderer.hxx>
 #include <Core.World/Physics.hxx>
@@ -17,42 +18,49 @@ namespace GameProject
 {
     using namespace Core;
 
+    //
+    // How bullets detect hits.
+    //
+    enum class LaserBulletMode : uint32_t
+    {
+        //
+        // Bullet is dynamic rigid body and hits through contact generation.
+        //
+        RigidBody,
+
+        //
+        // Bullet has no rigid body; scene traces its path each step with batched ray casts.
+        //
+        Hitscan,
+    };
+
     using LaserBulletRef = Reference<class LaserBullet>;
+    using LaserBulletPool = World::GameObjectPool<class LaserBullet>;
+    using LaserBulletPoolRef = Reference<LaserBulletPool>;
     class LaserBullet : public World::GameObject
     {
     public:
         static constexpr const World::GameObjectTypeID TypeID = "Game.LaserBullet"_hash32;
+        static constexpr const World::CollisionLayer Layer = 2;
 
     public:
         static constexpr const float TimeToLive = 10.0F;
+        static constexpr const float MoveVelocity = 16.0F;
 
     private:
-        Rendering::MeshRendererRef m_Mesh;
-        Rendering::MaterialRendererRef m_Material;
-        DirectX::XMFLOAT4X4A m_ScaleMatrix;
         DirectX::XMFLOAT4A m_Direction;
-        float m_MoveVelocity;
-        float m_LifeTime;
 
     public:
-        static LaserBulletRef Make(DirectX::FXMVECTOR position, DirectX::FXMVECTOR direction, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept;
+        static LaserBulletRef Make(DirectX::FXMVECTOR position, DirectX::FXMVECTOR direction, LaserBulletMode mode, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept;
 
     public:
-        LaserBullet(DirectX::FXMMATRIX transform, DirectX::FXMVECTOR direction, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept;
+        LaserBullet(DirectX::FXMVECTOR position, DirectX::FXMVECTOR direction, LaserBulletMode mode, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept;
         virtual ~LaserBullet() noexcept;
 
-        void SetMoveVelocity(float value) noexcept
-        {
-            m_MoveVelocity = value;
-        }
-
-    public:
-        virtual void OnUpdate(float deltaTime) noexcept override final;
-        virtual void OnRender(const Rendering::CommandListRef& commandList) noexcept override final;
-        virtual void OnCollision(GameObject* other) noexcept override final;
-
-    public:
-        DirectX::XMMATRIX XM_CALLCONV GetTransform() const noexcept override final;
+        //
+        // Reinitializes pooled bullet.
+        //
+        void XM_CALLCONV Reset(DirectX::FXMVECTOR position, DirectX::FXMVECTOR direction, LaserBulletMode mode, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept;
     };
 }
 
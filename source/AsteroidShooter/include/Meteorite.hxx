@@ -8,6 +8,7 @@
 //
 
 #include <Core.World/GameObject.hxx>
+#include <Core.World/GameObjectPool.hxx>
 #include <Core.Rendering/MaterialRenderer.hxx>
 #include <Core.Rendering/MeshRenderer.hxx>
 #include <Core.World/Physics.hxx>
@@ -18,17 +19,16 @@ namespace GameProject
     using namespace Core;
 
     using MeteoriteRef = Reference<class Meteorite>;
+    using MeteoritePool = World::GameObjectPool<class Meteorite>;
+    using MeteoritePoolRef = Reference<MeteoritePool>;
     class Meteorite : public World::GameObject
     {
     public:
         static constexpr const World::GameObjectTypeID TypeID = "Game.Meteorite"_hash32;
+        static constexpr const World::CollisionLayer Layer = 3;
         static constexpr const float TimeToLive = 6.0F; // Fair enough
     private:
-        Rendering::MeshRendererRef m_Mesh;
-        Rendering::MaterialRendererRef m_Material;
         DirectX::XMFLOAT4A m_DirectionForce;
-        DirectX::XMFLOAT4X4A m_ScaleMatrix;
-        float m_LifeTime;
 
     public:
         //
@@ -43,13 +43,16 @@ namespace GameProject
         Meteorite(DirectX::FXMVECTOR position, DirectX::FXMVECTOR orientation, DirectX::FXMVECTOR velocity, DirectX::GXMVECTOR size, DirectX::HXMVECTOR angularVelocity, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept;
         virtual ~Meteorite() noexcept;
 
-    public:
-        virtual void OnUpdate(float deltaTime) noexcept override final;
-        virtual void OnRender(const Rendering::CommandListRef& commandList) noexcept override final;
-        virtual void OnCollision(GameObject* other) noexcept override final;
+        //
+        // Reinitializes pooled meteorite.
+        //
+        void XM_CALLCONV Reset(DirectX::FXMVECTOR position, DirectX::FXMVECTOR orientation, DirectX::FXMVECTOR velocity, DirectX::GXMVECTOR size, DirectX::HXMVECTOR angularVelocity, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept;
 
     public:
-        virtual DirectX::XMMATRIX XM_CALLCONV GetTransform() const noexcept override final;
+        //
+        // Contact handler for meteorite and laser bullet pair.
+        //
+        static void OnBulletContact(World::GameObject* meteorite, World::GameObject* bullet) noexcept;
     };
 }
 
@@ -0,0 +1,65 @@
+#ifndef INCLUDED_GAME_METEORITESPAWNER_HXX
+#define INCLUDED_GAME_METEORITESPAWNER_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+#include <Core/Random.hxx>
+
+namespace GameProject
+{
+    using namespace Core;
+
+    //
+    // Initial state of single meteorite.
+    //
+    struct MeteoriteSpawn final
+    {
+        DirectX::XMFLOAT4A Position;
+        DirectX::XMFLOAT4A Velocity;
+        DirectX::XMFLOAT4A Size;
+        DirectX::XMFLOAT4A AngularVelocity;
+    };
+
+    //
+    // Generates meteorite spawns in batches.
+    //
+    // Spawns are computed four at a time, one per vector lane, from vectorized random generator.
+    // Burst of spawns costs the same as few calls to scalar generator.
+    //
+    class MeteoriteSpawner final
+    {
+    public:
+        static constexpr const uint32_t DefaultSeed = 5489U;
+
+        //
+        // Meteorites start this far ahead of ship.
+        //
+        static constexpr const float SpawnDistance = 40.0F;
+
+    private:
+        RandomGenerator m_Random;
+        std::vector<MeteoriteSpawn> m_Spawns;
+        float m_RangeExtent;
+
+    public:
+        //
+        // Meteorites are spawned and aimed within [-rangeExtent, rangeExtent] along X axis.
+        //
+        explicit MeteoriteSpawner(float rangeExtent) noexcept;
+
+    public:
+        void Seed(uint32_t seed) noexcept;
+
+        //
+        // Generates given number of spawns. Returned records are valid until next call.
+        //
+        const std::vector<MeteoriteSpawn>& Generate(size_t count) noexcept;
+    };
+}
+
+#endif // INCLUDED_GAME_METEORITESPAWNER_HXX
\ No newline at end of file
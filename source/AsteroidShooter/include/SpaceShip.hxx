@@ -12,6 +12,7 @@
 #include <Core.Rendering/MeshRenderer.hxx>
 #include <Core.World/Physics.hxx>
 #include <Core/StringHash.hxx>
+#include <LaserBullet.hxx>
 
 namespace GameProject
 {
@@ -22,20 +23,21 @@ namespace GameProject
     {
     public:
         static constexpr const World::GameObjectTypeID TypeID = "Game.SpaceShip"_hash32;
+        static constexpr const World::CollisionLayer Layer = 1;
         static constexpr const float FireInterval = 0.25F;
 
     private:
-        Rendering::MeshRendererRef m_Mesh;
-        Rendering::MaterialRendererRef m_Material;
         Rendering::MeshRendererRef m_BulletMesh;
         Rendering::MaterialRendererRef m_BulletMaterial;
-        World::Scene* m_Scene;
+        LaserBulletPoolRef m_BulletPool;
+        LaserBulletMode m_BulletMode;
         float m_MoveVelocity;
+        float m_TargetPosition;
         float m_FireTimeout;
         float m_CannonFlipFactor;
 
     public:
-        SpaceShip(World::Scene* scene, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material, const Rendering::MeshRendererRef& bulletMesh, const Rendering::MaterialRendererRef& bulletMaterial) noexcept;
+        SpaceShip(const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material, const Rendering::MeshRendererRef& bulletMesh, const Rendering::MaterialRendererRef& bulletMaterial, const LaserBulletPoolRef& bulletPool, LaserBulletMode bulletMode) noexcept;
         virtual ~SpaceShip() noexcept;
 
     public:
@@ -48,8 +50,12 @@ namespace GameProject
 
     public:
         virtual void OnUpdate(float deltaTime) noexcept override final;
-        virtual void OnRender(const Rendering::CommandListRef& commandList) noexcept override final;
-        virtual void OnCollision(GameObject* other) noexcept override final;
+
+    public:
+        //
+        // Contact handler for spaceship and meteorite pair.
+        //
+        static void OnMeteoriteContact(World::GameObject* spaceShip, World::GameObject* meteorite) noexcept;
     };
 
 }
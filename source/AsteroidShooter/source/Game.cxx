@@ -5,10 +5,14 @@
 //
 
 #include <Game.hxx>
+#include <Core/StringFormat.hxx>
+#include <Core.Diagnostics/Trace.hxx>
+#if !defined(CORE_HEADLESS)
 #include <Core/Environment.hxx>
 #include <Core/FileSystem.hxx>
 #include <Core/CoreApplication.hxx>
-#include <Core/StringFormat.hxx>
+#endif
+#include <cmath>
 
 namespace GameProject
 {
@@ -18,7 +22,6 @@ namespace GameProject
 
     Game::Game() noexcept
         : m_Scene{}
-        , m_Query{}
         , m_SpaceShipMaterial{}
         , m_SpaceShipMesh{}
         , m_BulletMaterial{}
@@ -26,21 +29,33 @@ namespace GameProject
         , m_MeteoriteMaterial{}
         , m_MeteoriteMesh{}
         , m_SpaceShip{}
+        , m_BulletPool{}
+        , m_MeteoritePool{}
         , m_MoveLeftVelocity{ 0.0F }
         , m_MoveRightVelocity{ 0.0F }
-        , m_RandomEngine{}
+        , m_Spawner{ VisibleRangeExtent }
         , m_SpawnTimeout{}
         , m_SpawnInterval{}
         , m_FrameCount{ 0 }
         , m_FrameCounterTimeout{ 0.0F }
         , m_FireDown{ false }
+        , m_IsPaused{ false }
         , m_IsRestarting{ false }
         , m_MeteoritesShotDown{ 0 }
+        , m_FixedSpawnInterval{ 0.0F }
+        , m_SpawnRate{ 0.0F }
+        , m_Seed{ MeteoriteSpawner::DefaultSeed }
+        , m_PhysicsBackend{ World::PhysicsBackend::PhysX }
+        , m_BulletMode{ LaserBulletMode::RigidBody }
+        , m_Recording{}
+        , m_Replay{}
     {
         CORE_ASSERT(Game::Current == nullptr);
         Game::Current = this;
 
+#if !defined(CORE_HEADLESS)
         ::ShowCursor(FALSE);
+#endif
     }
 
     Game::~Game() noexcept
@@ -49,6 +64,7 @@ namespace GameProject
         Game::Current = nullptr;
     }
 
+#if !defined(CORE_HEADLESS)
     void Game::OnWindowClose(CoreWindow* window) noexcept
     {
         (void)window;
@@ -58,19 +74,22 @@ namespace GameProject
 
     bool Game::OnKeyDown(uint32_t keyCode, char32_t character, bool isRepeat) noexcept
     {
-        (void)isRepeat;
+        if (isRepeat)
+        {
+            return true;
+        }
 
         if (character == 'a' || character == 'A' || keyCode == VK_LEFT)
         {
-            m_MoveLeftVelocity = -10.0F;
+            HandleInput(GameInput::MoveLeft, true);
         }
         else if (character == 'd' || character == 'D' || keyCode == VK_RIGHT)
         {
-            m_MoveRightVelocity = 10.0F;
+            HandleInput(GameInput::MoveRight, true);
         }
         else if (keyCode == VK_SPACE)
         {
-            m_FireDown = true;
+            HandleInput(GameInput::Fire, true);
         }
 
         return true;
@@ -82,15 +101,15 @@ namespace GameProject
 
         if (character == 'a' || character == 'A' || keyCode == VK_LEFT)
         {
-            m_MoveLeftVelocity = 0.0F;
+            HandleInput(GameInput::MoveLeft, false);
         }
         else if (character == 'd' || character == 'D' || keyCode == VK_RIGHT)
         {
-            m_MoveRightVelocity = 0.0F;
+            HandleInput(GameInput::MoveRight, false);
         }
         else if (keyCode == VK_SPACE)
         {
-            m_FireDown = false;
+            HandleInput(GameInput::Fire, false);
         }
 
         return true;
@@ -134,6 +153,7 @@ namespace GameProject
         (void)window;
         m_IsPaused = false;
     }
+#endif
 
     void Game::Tick(float deltaTime) noexcept
     {
@@ -145,6 +165,37 @@ namespace GameProject
             return;
         }
 
+        if (m_Replay != nullptr)
+        {
+            //
+            // Recorded frame time and input replace live ones.
+            //
+            deltaTime = m_Replay->GetDeltaTime();
+            m_Replay->Advance([this](GameInput input, bool isPressed)
+            {
+                ApplyInput(input, isPressed);
+            });
+        }
+        else if (m_Recording != nullptr)
+        {
+            m_Recording->RecordFrame(deltaTime);
+        }
+
+        //
+        // Complete physics step which was running while previous frame was rendered.
+        //
+        m_Scene->FetchResults();
+
+        //
+        // Contacts of fetched step may have destroyed spaceship already; restart before anything
+        // touches it.
+        //
+        if (m_IsRestarting)
+        {
+            DoRestart();
+            m_IsRestarting = false;
+        }
+
         ++m_FrameCount;
         m_FrameCounterTimeout += deltaTime;
 
@@ -164,8 +215,24 @@ namespace GameProject
                 shipPosition.x
             );
 
+#if defined(CORE_HEADLESS)
+            CORE_TRACE_MESSAGE(Info, "%s", text.c_str());
+#else
             m_Window->SetText(text.c_str());
 
+            const auto& stats = m_RenderStatistics;
+            CORE_TRACE_MESSAGE(Debug, "Draws: %" PRIu32 ", uniform uploads: %" PRIu32 ", binds issued/filtered: PSO %" PRIu32 "/%" PRIu32 ", CB %" PRIu32 "/%" PRIu32 ", VB %" PRIu32 "/%" PRIu32 ", IB %" PRIu32 "/%" PRIu32 ", Sampler %" PRIu32 "/%" PRIu32 ", Texture %" PRIu32 "/%" PRIu32,
+                stats.DrawCalls,
+                stats.UniformUploads,
+                stats.PipelineStates.Issued, stats.PipelineStates.Filtered,
+                stats.UniformBuffers.Issued, stats.UniformBuffers.Filtered,
+                stats.VertexBuffers.Issued, stats.VertexBuffers.Filtered,
+                stats.IndexBuffers.Issued, stats.IndexBuffers.Filtered,
+                stats.Samplers.Issued, stats.Samplers.Filtered,
+                stats.Textures.Issued, stats.Textures.Filtered
+            );
+#endif
+
             m_FrameCounterTimeout = 0.0F;
             m_FrameCount = 0;
         }
@@ -173,14 +240,20 @@ namespace GameProject
         //
         // Spawn meteorites.
         //
+        // All meteorites due in this frame are generated in single batch.
+        //
         m_SpawnTimeout += deltaTime;
 
+        size_t spawnCount = 0;
+
         while (m_SpawnTimeout >= m_SpawnInterval)
         {
             m_SpawnTimeout -= m_SpawnInterval;
-            SpawnMeteorite();
+            ++spawnCount;
         }
 
+        SpawnMeteorites(spawnCount);
+
         //
         // Set spaceship motion.
         //
@@ -210,6 +283,7 @@ namespace GameProject
         }
     }
 
+#if !defined(CORE_HEADLESS)
     void Game::Render(float deltaTime) noexcept
     {
         auto renderSystem = Rendering::RenderSystem::Current;
@@ -224,13 +298,17 @@ namespace GameProject
         //
         (void)deltaTime;
         auto commandList = renderSystem->GetImmediateCommandList();
-        m_Scene->OnRender(commandList);
+        commandList->ResetStatistics();
+        commandList->ResetUniformRing();
+        m_Scene->OnRender(commandList, m_Viewport);
+        m_RenderStatistics = commandList->GetStatistics();
 
         //
         // Present & flip.
         //
         renderSystem->EndDrawViewport(m_Viewport, true, 1);
     }
+#endif
 
     void Game::Restart() noexcept
     {
@@ -244,6 +322,73 @@ namespace GameProject
         RecomputeInterval();
     }
 
+    void Game::SetSeed(uint32_t seed) noexcept
+    {
+        m_Seed = seed;
+        m_Spawner.Seed(seed);
+    }
+
+    void Game::SetSpawnRate(float rate) noexcept
+    {
+        m_SpawnRate = rate;
+        m_FixedSpawnInterval = (rate > 0.0F) ? (1.0F / rate) : 0.0F;
+
+        RecomputeInterval();
+    }
+
+    void Game::HandleInput(GameInput input, bool isPressed) noexcept
+    {
+        if (m_Replay != nullptr)
+        {
+            return;
+        }
+
+        if (m_Recording != nullptr)
+        {
+            m_Recording->RecordInput(input, isPressed);
+        }
+
+        ApplyInput(input, isPressed);
+    }
+
+    void Game::ApplyInput(GameInput input, bool isPressed) noexcept
+    {
+        switch (input)
+        {
+        case GameInput::MoveLeft:
+            m_MoveLeftVelocity = isPressed ? -10.0F : 0.0F;
+            break;
+        case GameInput::MoveRight:
+            m_MoveRightVelocity = isPressed ? 10.0F : 0.0F;
+            break;
+        case GameInput::Fire:
+            m_FireDown = isPressed;
+            break;
+        }
+    }
+
+    void Game::BeginRecording() noexcept
+    {
+        CORE_ASSERT(m_Scene == nullptr);
+        CORE_ASSERT(m_Replay == nullptr);
+
+        m_Recording = MakeRef<InputRecording>(m_Seed, m_SpawnRate, m_PhysicsBackend, m_BulletMode);
+    }
+
+    void Game::BeginReplay(const InputRecordingRef& recording) noexcept
+    {
+        CORE_ASSERT(m_Scene == nullptr);
+        CORE_ASSERT(recording != nullptr);
+
+        m_Recording = recording;
+        m_Replay = std::make_unique<InputReplay>(recording);
+
+        SetSeed(recording->GetSeed());
+        SetSpawnRate(recording->GetSpawnRate());
+        SetPhysicsBackend(recording->GetBackend());
+        SetBulletMode(recording->GetBulletMode());
+    }
+
     void Game::DoRestart() noexcept
     {
         if (m_Scene != nullptr)
@@ -257,8 +402,20 @@ namespace GameProject
         //
         // Create scene with zero gravity.
         //
-        m_Scene = World::Physics::MakeScene(DirectX::XMFLOAT3(0.0F, 0.0F, 0.0F));
+        m_Scene = World::Physics::MakeScene(DirectX::XMFLOAT3(0.0F, 0.0F, 0.0F), m_PhysicsBackend);
+
+        //
+        // Overlap physics with rendering.
+        //
+        m_Scene->SetAsyncSimulation(true);
 
+        //
+        // Collisions are handled per type pair after physics step.
+        //
+        m_Scene->RegisterContactHandler(Meteorite::TypeID, LaserBullet::TypeID, &Meteorite::OnBulletContact);
+        m_Scene->RegisterContactHandler(SpaceShip::TypeID, Meteorite::TypeID, &SpaceShip::OnMeteoriteContact);
+
+#if !defined(CORE_HEADLESS)
         //
         // Setup scene camera.
         //
@@ -269,16 +426,18 @@ namespace GameProject
             DirectX::XMVectorSet(0.0F, 0.0F, 10.0F, 0.0F),
             DirectX::XMVectorSet(0.0F, 1.0F, 0.0F, 0.0F)
         );
+#endif
 
         //
         // Make spaceship.
         //
         m_SpaceShip = MakeRef<SpaceShip>(
-            m_Scene.Get(),
             m_SpaceShipMesh,
             m_SpaceShipMaterial,
             m_BulletMesh,
-            m_BulletMaterial
+            m_BulletMaterial,
+            m_BulletPool,
+            m_BulletMode
             );
 
         //
@@ -305,6 +464,12 @@ namespace GameProject
 
     void Game::RecomputeInterval() noexcept
     {
+        if (m_FixedSpawnInterval > 0.0F)
+        {
+            m_SpawnInterval = m_FixedSpawnInterval;
+            return;
+        }
+
         const auto ranged = static_cast<float>(Clamp<uint32_t>(
             static_cast<uint32_t>(m_MeteoritesShotDown / 1.7F),
             1,
@@ -326,6 +491,7 @@ namespace GameProject
 
     void Game::Initialize() noexcept
     {
+#if !defined(CORE_HEADLESS)
         auto application = CoreApplication::Current;
         auto renderSystem = Rendering::RenderSystem::Current;
 
@@ -360,7 +526,8 @@ namespace GameProject
         //
         m_MeteoriteMaterial = MakeRef<Rendering::MaterialRenderer>(
             "./shaders/DiffuseMaterial.ps.cso",
-            "./shaders/DiffuseMaterial.vs.cso"
+            "./shaders/DiffuseMaterial.vs.cso",
+            "./shaders/DiffuseMaterial.Instanced.vs.cso"
             );
         m_MeteoriteMaterial->SetDiffuseColor(DirectX::Colors::Silver);
         m_MeteoriteMaterial->SetTextureSampler(defaultSampler);
@@ -372,7 +539,8 @@ namespace GameProject
         //
         m_SpaceShipMaterial = MakeRef<Rendering::MaterialRenderer>(
             "./shaders/DiffuseMaterial.ps.cso",
-            "./shaders/DiffuseMaterial.vs.cso"
+            "./shaders/DiffuseMaterial.vs.cso",
+            "./shaders/DiffuseMaterial.Instanced.vs.cso"
             );
         m_SpaceShipMaterial->SetDiffuseColor(DirectX::Colors::LightSalmon);
         m_SpaceShipMaterial->SetTexture(renderSystem->MakeTexture2D("assets/textures/ship.dds"));
@@ -384,204 +552,73 @@ namespace GameProject
         //
         m_BulletMaterial = MakeRef<Rendering::MaterialRenderer>(
             "./shaders/EmissiveMaterial.ps.cso",
-            "./shaders/EmissiveMaterial.vs.cso"
+            "./shaders/EmissiveMaterial.vs.cso",
+            "./shaders/EmissiveMaterial.Instanced.vs.cso"
             );
         m_BulletMaterial->SetDiffuseColor(DirectX::Colors::LightSalmon);
         m_BulletMaterial->SetTexture(renderSystem->MakeTexture2D("assets/textures/bullet.dds"));
         m_BulletMaterial->SetTextureSampler(defaultSampler);
         m_BulletMesh = MakeRef<Rendering::MeshRenderer>();
+#endif
 
         //
-        // Just restart game :)
+        // Object pools.
         //
-        DoRestart();
-    }
-
-    void Game::Shutdown() noexcept
-    {
-        m_Viewport = nullptr;
-
-        m_Window->Destroy();
-        m_Window = nullptr;
-    }
-
-    DirectX::XMVECTOR XM_CALLCONV Game::RandomVector2D() noexcept
-    {
-        DirectX::XMFLOAT2A result;
-
-        std::uniform_real<float> distribution{};
-
-        result.x = distribution(m_RandomEngine);
-        result.y = distribution(m_RandomEngine);
-
-        return DirectX::XMVector2Normalize(DirectX::XMLoadFloat2A(&result));
-    }
-
-    DirectX::XMVECTOR XM_CALLCONV Game::RandomVector3D() noexcept
-    {
-        DirectX::XMFLOAT3A result;
-
-        std::uniform_real<float> distribution{};
-
-        result.x = distribution(m_RandomEngine);
-        result.y = distribution(m_RandomEngine);
-        result.z = distribution(m_RandomEngine);
-
-        return DirectX::XMVector3Normalize(DirectX::XMLoadFloat3A(&result));
-    }
-
-    DirectX::XMVECTOR XM_CALLCONV Game::RandomVector3D(DirectX::FXMVECTOR min, DirectX::FXMVECTOR max) noexcept
-    {
-        DirectX::XMFLOAT3A vmin;
-        DirectX::XMFLOAT3A vmax;
-
-        DirectX::XMStoreFloat3A(&vmin, min);
-        DirectX::XMStoreFloat3A(&vmax, max);
-
-        std::uniform_real<float> distributionX{ vmin.x, vmax.x };
-        std::uniform_real<float> distributionY{ vmin.y, vmax.y };
-        std::uniform_real<float> distributionZ{ vmin.z, vmax.z };
-
-        DirectX::XMFLOAT3A result;
-        result.x = distributionX(m_RandomEngine);
-        result.y = distributionY(m_RandomEngine);
-        result.z = distributionZ(m_RandomEngine);
-        
-        return DirectX::XMLoadFloat3A(&result);
-    }
-
-    DirectX::XMVECTOR XM_CALLCONV Game::RandomUnitVector() noexcept
-    {
-        std::uniform_real<float> uniform{};
+        m_BulletPool = MakeRef<LaserBulletPool>();
+        m_MeteoritePool = MakeRef<MeteoritePool>();
 
         //
-        // Compute random `signum` for target axis vector.
+        // Only meteorites hitting spaceship or bullets matter; everything else is dropped by
+        // broadphase.
         //
-        auto signum = (uniform(m_RandomEngine) > 0.5F) ? 1.0F : -1.0F;
+        const World::CollisionLayer layers[] = { SpaceShip::Layer, LaserBullet::Layer, Meteorite::Layer };
 
-        DirectX::XMFLOAT3A axis;
-        axis.x = uniform(m_RandomEngine);
-        axis.y = uniform(m_RandomEngine);
-
-        //
-        // Square known two components.
-        //
-        const auto x2 = axis.x * axis.x;
-        const auto y2 = axis.y * axis.y;
-
-        //
-        // And final z component.
-        //
-        axis.z = signum * std::sqrt(1.0F - x2 - y2);
-
-        const auto result = DirectX::XMLoadFloat3A(&axis);
-        return result;
-    }
-
-    DirectX::XMVECTOR XM_CALLCONV Game::RandomQuaternion() noexcept
-    {
-        std::uniform_real<float> uniform{};
-        std::uniform_real<float> randomAngle{0.0F, DirectX::XM_2PI};
-
-
-        //
-        // Compute random angle.
-        //
-        const auto angle = randomAngle(m_RandomEngine);
+        for (auto layer0 : layers)
+        {
+            for (auto layer1 : layers)
+            {
+                World::Physics::SetCollisionResponse(layer0, layer1, World::CollisionResponse::None);
+            }
+        }
 
-        //
-        // And random axis.
-        //
-        const auto axis = RandomUnitVector();
+        World::Physics::SetCollisionResponse(Meteorite::Layer, SpaceShip::Layer, World::CollisionResponse::Resolve | World::CollisionResponse::Notify);
+        World::Physics::SetCollisionResponse(Meteorite::Layer, LaserBullet::Layer, World::CollisionResponse::Resolve | World::CollisionResponse::Notify);
 
         //
-        // And create quaternion from it.
+        // Just restart game :)
         //
-        const auto result = DirectX::XMQuaternionRotationAxis(axis, angle);
-        return result;
+        DoRestart();
     }
 
-    DirectX::XMVECTOR XM_CALLCONV Game::RandomAngularVelocity(float max) noexcept
+    void Game::Shutdown() noexcept
     {
-        std::uniform_real<float> uniform{};
-
-        DirectX::XMFLOAT3A vector;
-        vector.x = uniform(m_RandomEngine);
-        vector.y = uniform(m_RandomEngine);
-        vector.z = uniform(m_RandomEngine);
-
-        const auto result = DirectX::XMVectorScale(DirectX::XMLoadFloat3A(&vector), max);
-        return result;
-    }
+#if !defined(CORE_HEADLESS)
+        m_Viewport = nullptr;
 
-    float Game::RandomScalar(float min, float max) noexcept
-    {
-        std::uniform_real<float> distribution{ min, max };
-        return distribution(m_RandomEngine);
+        m_Window->Destroy();
+        m_Window = nullptr;
+#endif
     }
 
-    void Game::SpawnMeteorite() noexcept
+    void Game::SpawnMeteorites(size_t count) noexcept
     {
-        //
-        // Spawn range is wide spreaded
-        //
-        auto spawnRange = RandomScalar(-VisibleRangeExtent, VisibleRangeExtent);
-
-        //
-        // However, target range is condense.
-        //
-        auto targetRange = RandomScalar(-VisibleRangeExtent, VisibleRangeExtent) * 0.5F;
-        
-        //
-        // Copmute spawn point.
-        //
-        auto spawnPoint = DirectX::XMVectorSet(spawnRange, 0.0F, 40.0F, 0.0F);
-
-        //
-        // Compute desired hit target point.
-        //
-        auto hitPoint = DirectX::XMVectorSet(spawnRange + targetRange, 0.0F, 0.0F, 0.0F);
-
-        //
-        // And finally velocity vector.
-        //
-        auto velocityNormal = DirectX::XMVector3Normalize(DirectX::XMVectorSubtract(hitPoint, spawnPoint));
-
-        //
-        // Select some random velocity.
-        //
-        auto velocityValue = RandomScalar(10.0F, 15.0F);
-
-        //
-        // Compute resulting velocity.
-        //
-        auto velocity = DirectX::XMVectorScale(velocityNormal, velocityValue);
-
-        auto size = RandomVector3D(
-            DirectX::XMVectorSet(1.0F, 1.0F, 1.0F, 0.0F),
-            DirectX::XMVectorSet(2.5F, 2.5F, 2.5F, 0.0F)
-        );
-
-        //
-        // Compute random orientation quaternion.
-        //
-        auto randomAngularVelocity = RandomAngularVelocity(2.0F);
-
-        //
-        // Make meteorite.
-        //
-        auto meteorite = Meteorite::Make(
-            spawnPoint,
-            DirectX::XMQuaternionIdentity(),
-            velocity,
-            size,
-            randomAngularVelocity,
-            m_MeteoriteMesh,
-            m_MeteoriteMaterial);
+        if (count == 0)
+        {
+            return;
+        }
 
-        //
-        // And add it to scene.
-        //
-        m_Scene->Add(meteorite);
+        for (const auto& spawn : m_Spawner.Generate(count))
+        {
+            auto meteorite = m_MeteoritePool->Acquire(
+                DirectX::XMLoadFloat4A(&spawn.Position),
+                DirectX::XMQuaternionIdentity(),
+                DirectX::XMLoadFloat4A(&spawn.Velocity),
+                DirectX::XMLoadFloat4A(&spawn.Size),
+                DirectX::XMLoadFloat4A(&spawn.AngularVelocity),
+                m_MeteoriteMesh,
+                m_MeteoriteMaterial);
+
+            m_Scene->Add(meteorite);
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,243 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <InputRecording.hxx>
+#include <Core.Diagnostics/Debug.hxx>
+#include <Core.Diagnostics/Trace.hxx>
+#include <cstring>
+
+namespace GameProject
+{
+    namespace
+    {
+        //
+        // File layout, little endian:
+        //
+        //      header      Magic, Version, Seed, SpawnRate, Backend, BulletMode, FrameCount, FrameTimesCount, EventsCount
+        //      frame times FrameTimesCount * { uint32 Frame, float DeltaTime }
+        //      events      EventsCount * { uint32 Frame, uint8 Input | (IsPressed << 7) }
+        //
+        constexpr const uint32_t RecordingMagic = 0x43455341; // "ASEC"
+        constexpr const uint32_t RecordingVersion = 4;
+        constexpr const uint8_t PressedBit = 0x80;
+
+        //
+        // Sizes of serialized records.
+        //
+        constexpr const uint64_t FrameTimeRecordSize = sizeof(uint32_t) + sizeof(float);
+        constexpr const uint64_t EventRecordSize = sizeof(uint32_t) + sizeof(uint8_t);
+
+        template <typename T>
+        void Write(std::ofstream& stream, const T& value) noexcept
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivial values may be written");
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        bool Read(std::ifstream& stream, T& value) noexcept
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivial values may be read");
+            return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+    }
+
+    InputRecording::InputRecording(uint32_t seed, float spawnRate, World::PhysicsBackend backend, LaserBulletMode bulletMode) noexcept
+        : m_Seed{ seed }
+        , m_SpawnRate{ spawnRate }
+        , m_Backend{ backend }
+        , m_BulletMode{ bulletMode }
+        , m_FrameCount{ 0 }
+        , m_FrameTimes{}
+        , m_Events{}
+    {
+    }
+
+    InputRecording::~InputRecording() noexcept
+    {
+    }
+
+    InputRecordingRef InputRecording::Load(const char* path) noexcept
+    {
+        std::ifstream stream{ path, std::ios::binary };
+
+        if (!stream)
+        {
+            CORE_TRACE_MESSAGE(Error, "[Recording] Can't open `%s`", path);
+            return nullptr;
+        }
+
+        uint32_t magic{};
+        uint32_t version{};
+        uint32_t seed{};
+        float spawnRate{};
+        uint32_t backend{};
+        uint32_t bulletMode{};
+        uint32_t frameCount{};
+        uint32_t frameTimesCount{};
+        uint32_t eventsCount{};
+
+        if (!Read(stream, magic) || magic != RecordingMagic || !Read(stream, version) || version != RecordingVersion)
+        {
+            CORE_TRACE_MESSAGE(Error, "[Recording] `%s` is not a recording", path);
+            return nullptr;
+        }
+
+        if (!Read(stream, seed) || !Read(stream, spawnRate) || !Read(stream, backend) || !Read(stream, bulletMode) || !Read(stream, frameCount) || !Read(stream, frameTimesCount) || !Read(stream, eventsCount))
+        {
+            CORE_TRACE_MESSAGE(Error, "[Recording] `%s` is truncated", path);
+            return nullptr;
+        }
+
+        if (backend > static_cast<uint32_t>(World::PhysicsBackend::Planar) || bulletMode > static_cast<uint32_t>(LaserBulletMode::Hitscan))
+        {
+            CORE_TRACE_MESSAGE(Error, "[Recording] `%s` has invalid settings", path);
+            return nullptr;
+        }
+
+        //
+        // Counts must be backed by data actually present in file, so corrupted header can't make
+        // us allocate arbitrary amount of memory.
+        //
+        const auto position = stream.tellg();
+        stream.seekg(0, std::ios::end);
+        const auto end = stream.tellg();
+        stream.seekg(position);
+
+        if (!stream || position < 0 || end < position)
+        {
+            CORE_TRACE_MESSAGE(Error, "[Recording] Failed to read `%s`", path);
+            return nullptr;
+        }
+
+        const auto remaining = static_cast<uint64_t>(end - position);
+
+        if (frameTimesCount * FrameTimeRecordSize + eventsCount * EventRecordSize > remaining)
+        {
+            CORE_TRACE_MESSAGE(Error, "[Recording] `%s` is truncated", path);
+            return nullptr;
+        }
+
+        auto result = MakeRef<InputRecording>(seed, spawnRate, static_cast<World::PhysicsBackend>(backend), static_cast<LaserBulletMode>(bulletMode));
+        result->m_FrameCount = frameCount;
+        result->m_FrameTimes.resize(frameTimesCount);
+        result->m_Events.resize(eventsCount);
+
+        for (auto& frameTime : result->m_FrameTimes)
+        {
+            if (!Read(stream, frameTime.Frame) || !Read(stream, frameTime.DeltaTime))
+            {
+                CORE_TRACE_MESSAGE(Error, "[Recording] `%s` is truncated", path);
+                return nullptr;
+            }
+        }
+
+        for (auto& event : result->m_Events)
+        {
+            uint8_t packed{};
+
+            if (!Read(stream, event.Frame) || !Read(stream, packed))
+            {
+                CORE_TRACE_MESSAGE(Error, "[Recording] `%s` is truncated", path);
+                return nullptr;
+            }
+
+            const auto input = static_cast<uint8_t>(packed & ~PressedBit);
+
+            if (input > static_cast<uint8_t>(GameInput::Fire))
+            {
+                CORE_TRACE_MESSAGE(Error, "[Recording] `%s` has invalid input event", path);
+                return nullptr;
+            }
+
+            event.Input = static_cast<GameInput>(input);
+            event.IsPressed = (packed & PressedBit) != 0;
+        }
+
+        CORE_TRACE_MESSAGE(Info, "[Recording] Loaded `%s`: %" PRIu32 " frames, %zu events", path, frameCount, result->m_Events.size());
+        return result;
+    }
+
+    bool InputRecording::Save(const char* path) const noexcept
+    {
+        std::ofstream stream{ path, std::ios::binary | std::ios::trunc };
+
+        Write(stream, RecordingMagic);
+        Write(stream, RecordingVersion);
+        Write(stream, m_Seed);
+        Write(stream, m_SpawnRate);
+        Write(stream, m_Backend);
+        Write(stream, m_BulletMode);
+        Write(stream, m_FrameCount);
+        Write(stream, static_cast<uint32_t>(m_FrameTimes.size()));
+        Write(stream, static_cast<uint32_t>(m_Events.size()));
+
+        for (const auto& frameTime : m_FrameTimes)
+        {
+            Write(stream, frameTime.Frame);
+            Write(stream, frameTime.DeltaTime);
+        }
+
+        for (const auto& event : m_Events)
+        {
+            Write(stream, event.Frame);
+            Write(stream, static_cast<uint8_t>(static_cast<uint8_t>(event.Input) | (event.IsPressed ? PressedBit : 0)));
+        }
+
+        if (!stream)
+        {
+            CORE_TRACE_MESSAGE(Error, "[Recording] Failed to write `%s`", path);
+            return false;
+        }
+
+        CORE_TRACE_MESSAGE(Info, "[Recording] Saved `%s`: %" PRIu32 " frames, %zu events", path, m_FrameCount, m_Events.size());
+        return true;
+    }
+
+    void InputRecording::RecordFrame(float deltaTime) noexcept
+    {
+        //
+        // Compare bit patterns; replay must see exactly the same values.
+        //
+        if (m_FrameTimes.empty() || std::memcmp(&m_FrameTimes.back().DeltaTime, &deltaTime, sizeof(float)) != 0)
+        {
+            m_FrameTimes.push_back({ m_FrameCount, deltaTime });
+        }
+
+        ++m_FrameCount;
+    }
+
+    void InputRecording::RecordInput(GameInput input, bool isPressed) noexcept
+    {
+        //
+        // Input arriving between frames is applied before next one.
+        //
+        m_Events.push_back({ m_FrameCount, input, isPressed });
+    }
+
+    InputReplay::InputReplay(const InputRecordingRef& recording) noexcept
+        : m_Recording{ recording }
+        , m_Frame{ 0 }
+        , m_NextFrameTime{ 0 }
+        , m_NextEvent{ 0 }
+        , m_DeltaTime{ 0.0F }
+    {
+        CORE_ASSERT(recording != nullptr);
+    }
+
+    float InputReplay::GetDeltaTime() noexcept
+    {
+        const auto& frameTimes = m_Recording->GetFrameTimes();
+
+        while (m_NextFrameTime < frameTimes.size() && frameTimes[m_NextFrameTime].Frame <= m_Frame)
+        {
+            m_DeltaTime = frameTimes[m_NextFrameTime].DeltaTime;
+            ++m_NextFrameTime;
+        }
+
+        return m_DeltaTime;
+    }
+}
\ No newline at end of file
@@ -8,96 +8,59 @@
 
 namespace GameProject
 {
-    LaserBulletRef LaserBullet::Make(DirectX::FXMVECTOR position, DirectX::FXMVECTOR direction, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept
+    LaserBulletRef LaserBullet::Make(DirectX::FXMVECTOR position, DirectX::FXMVECTOR direction, LaserBulletMode mode, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept
     {
-        auto normalizedDirection = DirectX::XMVector3Normalize(direction);
-        auto transform = DirectX::XMMatrixTranslationFromVector(position);
-        auto result = MakeRef<LaserBullet>(transform, direction, mesh, material);
+        auto result = MakeRef<LaserBullet>(position, direction, mode, mesh, material);
         return result;
     }
 
-    LaserBullet::LaserBullet(DirectX::FXMMATRIX transform, DirectX::FXMVECTOR direction, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept
+    LaserBullet::LaserBullet(DirectX::FXMVECTOR position, DirectX::FXMVECTOR direction, LaserBulletMode mode, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept
         : GameObject(LaserBullet::TypeID)
-        , m_Mesh{ mesh }
-        , m_Material{ material }
-        , m_ScaleMatrix{}
         , m_Direction{}
-        , m_MoveVelocity{ 16.0F }
-        , m_LifeTime{ 0.0F }
     {
         //
-        // Setups rigid body.
+        // Bullet moves with constant velocity and dies after some time. Scene handles both.
         //
         const auto scale = DirectX::XMVectorSet(0.2F, 0.2F, 1.0F, 0.0F);
 
-        const auto scaleMatrix = DirectX::XMMatrixScalingFromVector(scale);
-
-        DirectX::XMStoreFloat4A(&m_Direction, direction);
-        DirectX::XMStoreFloat4x4A(&m_ScaleMatrix, scaleMatrix);
-
-        m_RigidBody = World::Physics::MakeRigidBody();
-        m_RigidBody->userData = reinterpret_cast<void*>(this);
-        m_RigidBody->setGlobalPose(World::Converters::XMMATRIXToPxTransform(transform));
-        m_RigidBody->setActorFlag(physx::PxActorFlag::eDISABLE_GRAVITY, false);
-        m_RigidBody->setRigidDynamicFlag(physx::PxRigidBodyFlag::eKINEMATIC, false);
-
-        auto shape = World::Physics::MakeBoxCollider(DirectX::XMVectorScale(scale, 0.5F));
-        m_RigidBody->attachShape(*shape);
-    }
-
-    LaserBullet::~LaserBullet() noexcept
-    {
-    }
-
-    void LaserBullet::OnUpdate(float deltaTime) noexcept
-    {
-        m_LifeTime += deltaTime;
+        m_TimeToLive = LaserBullet::TimeToLive;
+        DirectX::XMStoreFloat4A(&m_Scale, scale);
 
         //
-        // Check if meteorite passed it lifetime.
+        // Setups body. Hitscan bullets use it only as bounds and velocity.
         //
-        if (m_LifeTime > LaserBullet::TimeToLive)
-        {
-            Destroy();
-        }
+        DirectX::XMStoreFloat4A(&m_Body.Extent, DirectX::XMVectorScale(scale, 0.5F));
+        m_Body.Velocity = DirectX::XMFLOAT4A{ 0.0F, 0.0F, LaserBullet::MoveVelocity, 0.0F };
+        m_Body.Layer = LaserBullet::Layer;
 
-        //
-        // Setup forward linear velocity.
-        //
-        m_RigidBody->setLinearVelocity(physx::PxVec3{ 0.0F, 0.0F, m_MoveVelocity });
+        Reset(position, direction, mode, mesh, material);
     }
 
-    void LaserBullet::OnRender(const Rendering::CommandListRef& commandList) noexcept
+    void XM_CALLCONV LaserBullet::Reset(DirectX::FXMVECTOR position, DirectX::FXMVECTOR direction, LaserBulletMode mode, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material) noexcept
     {
-        //
-        // Bind material.
-        //
-        m_Material->Bind(commandList);
+        m_Mesh = mesh;
+        m_Material = material;
 
-        //
-        // And render mesh.
-        //
-        m_Mesh->Bind(commandList);
-        m_Mesh->Render(commandList);
-    }
+        if (mode == LaserBulletMode::Hitscan)
+        {
+            m_ComponentFlags = World::ComponentFlags::Projectile;
+            m_Body.IsEnabled = false;
+        }
+        else
+        {
+            m_ComponentFlags = World::ComponentFlags::DrivenVelocity;
+            m_Body.IsEnabled = true;
+        }
 
-    void LaserBullet::OnCollision(GameObject* other) noexcept
-    {
-        (void)other;
+        DirectX::XMStoreFloat4A(&m_Direction, direction);
 
         //
-        // Bullet destroys itself.
+        // Scene applies body state when bullet is added.
         //
-        Destroy();
+        DirectX::XMStoreFloat4A(&m_Body.Position, position);
     }
 
-    DirectX::XMMATRIX XM_CALLCONV LaserBullet::GetTransform() const noexcept
+    LaserBullet::~LaserBullet() noexcept
     {
-        //
-        // Prepend scaling matrix to result transform.
-        //
-        auto scaling = DirectX::XMLoadFloat4x4A(&m_ScaleMatrix);
-
-        return DirectX::XMMatrixMultiply(scaling, GameObject::GetTransform());
     }
 }
\ No newline at end of file
@@ -5,7 +5,9 @@
 //
 
 #include <Windows.h>
+#include <shellapi.h>
 #include <Core/Environment.hxx>
+#include <Core/Jobs.hxx>
 #include <Core.Diagnostics/Trace.hxx>
 #include <Core.Diagnostics/Debug.hxx>
 #include <Core/CoreApplication.hxx>
@@ -15,6 +17,8 @@
 #include <Core/FileSystem.hxx>
 #include <Core.World/Physics.hxx>
 #include <algorithm>
+#include <codecvt>
+#include <string>
 
 //
 // Sorry. It was easier this way :P
@@ -35,6 +39,8 @@
 #pragma comment(lib, "PhysXProfileSDKDEBUG.lib")
 #endif
 
+#pragma comment(lib, "Shell32.lib")
+
 //
 // Game definition.
 //
@@ -55,11 +61,72 @@ INT WINAPI WinMain(
         (void)lpszCommandLine;
         (void)nShowCommand;
 
+        //
+        // Sessions may be recorded with `-record <path>` or replayed with `-replay <path>`. Shell
+        // splits command line, so quoted paths and further arguments are handled properly.
+        //
+        std::string recordPath{};
+        std::string replayPath{};
+
+        {
+            int argc = 0;
+            auto argv = ::CommandLineToArgvW(::GetCommandLineW(), &argc);
+
+            if (argv != nullptr)
+            {
+                std::wstring_convert<std::codecvt_utf8<wchar_t>> converter{};
+
+                for (int i = 1; i < argc; ++i)
+                {
+                    const std::wstring argument{ argv[i] };
+
+                    if (argument == L"-record" && i + 1 < argc)
+                    {
+                        recordPath = converter.to_bytes(argv[++i]);
+                    }
+                    else if (argument == L"-replay" && i + 1 < argc)
+                    {
+                        replayPath = converter.to_bytes(argv[++i]);
+                    }
+                    else
+                    {
+                        CORE_TRACE_MESSAGE(Warn, "Ignoring command line argument `%s`", converter.to_bytes(argument).c_str());
+                    }
+                }
+
+                ::LocalFree(argv);
+            }
+        }
+
+        //
+        // Replay requested explicitly must not silently turn into live game.
+        //
+        GameProject::InputRecordingRef replay{};
+
+        if (!replayPath.empty())
+        {
+            replay = GameProject::InputRecording::Load(replayPath.c_str());
+
+            if (replay == nullptr)
+            {
+                std::wstring_convert<std::codecvt_utf8<wchar_t>> converter{};
+                auto message = L"Failed to load replay `" + converter.from_bytes(replayPath) + L"`.";
+
+                ::MessageBoxW(0, message.c_str(), L"Replay", MB_OK | MB_ICONERROR);
+                return 1;
+            }
+        }
+
         //
         // Initialize basic environment.
         //
         Core::Environment::Initialize(hThisInstance);
 
+        //
+        // Start job system. Physics runs its tasks on it.
+        //
+        Core::Jobs::Initialize();
+
         //
         // Initialize physics.
         //
@@ -93,6 +160,15 @@ INT WINAPI WinMain(
                     //
                     Core::CoreApplication::PumpMessages();
 
+                    if (replay != nullptr)
+                    {
+                        game->BeginReplay(replay);
+                    }
+                    else if (!recordPath.empty())
+                    {
+                        game->BeginRecording();
+                    }
+
                     //
                     // All systems working. Instantiate game.
                     //
@@ -155,6 +231,11 @@ INT WINAPI WinMain(
                         Core::CoreApplication::PumpMessages();
                     }
 
+                    if (!recordPath.empty())
+                    {
+                        game->GetRecording()->Save(recordPath.c_str());
+                    }
+
                     //
                     // Shutdown game.
                     //
@@ -168,6 +249,11 @@ INT WINAPI WinMain(
         //
         Core::World::Physics::Shutdown();
 
+        //
+        // Stop worker threads.
+        //
+        Core::Jobs::Shutdown();
+
         //
         // And basic environment.
         //
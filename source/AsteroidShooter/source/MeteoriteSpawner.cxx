@@ -0,0 +1,95 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <MeteoriteSpawner.hxx>
+
+namespace GameProject
+{
+    MeteoriteSpawner::MeteoriteSpawner(float rangeExtent) noexcept
+        : m_Random{ DefaultSeed }
+        , m_Spawns{}
+        , m_RangeExtent{ rangeExtent }
+    {
+    }
+
+    void MeteoriteSpawner::Seed(uint32_t seed) noexcept
+    {
+        m_Random.Seed(seed);
+    }
+
+    const std::vector<MeteoriteSpawn>& MeteoriteSpawner::Generate(size_t count) noexcept
+    {
+        //
+        // Whole batches are generated, so random sequence depends only on number of batches.
+        //
+        const auto batches = (count + 3) / 4;
+        m_Spawns.resize(batches * 4);
+
+        const auto zero = DirectX::XMVectorZero();
+        const auto extent = DirectX::XMVectorReplicate(m_RangeExtent);
+        const auto distance = DirectX::XMVectorReplicate(-SpawnDistance);
+        const auto minSpeed = DirectX::XMVectorReplicate(10.0F);
+        const auto maxSpeed = DirectX::XMVectorReplicate(15.0F);
+        const auto minSize = DirectX::XMVectorReplicate(1.0F);
+        const auto maxSize = DirectX::XMVectorReplicate(2.5F);
+
+        for (size_t batch = 0; batch < batches; ++batch)
+        {
+            //
+            // Spawn range is wide spreaded, however target range is condense.
+            //
+            const auto spawnX = m_Random.NextVector(DirectX::XMVectorNegate(extent), extent);
+            const auto targetX = DirectX::XMVectorScale(m_Random.NextVector(DirectX::XMVectorNegate(extent), extent), 0.5F);
+
+            //
+            // Fly from (x, 0, distance) towards (x + target, 0, 0) with random speed.
+            //
+            const auto speed = m_Random.NextVector(minSpeed, maxSpeed);
+            const auto length = DirectX::XMVectorReciprocalSqrt(DirectX::XMVectorMultiplyAdd(targetX, targetX, DirectX::XMVectorMultiply(distance, distance)));
+            const auto scale = DirectX::XMVectorMultiply(speed, length);
+            const auto velocityX = DirectX::XMVectorMultiply(targetX, scale);
+            const auto velocityZ = DirectX::XMVectorMultiply(distance, scale);
+
+            //
+            // Snap size to quarter units, so meteorites share limited set of collider shapes.
+            //
+            DirectX::XMVECTOR size[3];
+
+            for (auto& axis : size)
+            {
+                axis = DirectX::XMVectorScale(DirectX::XMVectorRound(DirectX::XMVectorScale(m_Random.NextVector(minSize, maxSize), 4.0F)), 0.25F);
+            }
+
+            DirectX::XMVECTOR angularVelocity[3];
+
+            for (auto& axis : angularVelocity)
+            {
+                axis = DirectX::XMVectorScale(m_Random.NextVector(), 2.0F);
+            }
+
+            //
+            // Transpose lanes into records.
+            //
+            const auto positions = DirectX::XMMatrixTranspose(DirectX::XMMATRIX{ spawnX, zero, DirectX::XMVectorReplicate(SpawnDistance), zero });
+            const auto velocities = DirectX::XMMatrixTranspose(DirectX::XMMATRIX{ velocityX, zero, velocityZ, zero });
+            const auto sizes = DirectX::XMMatrixTranspose(DirectX::XMMATRIX{ size[0], size[1], size[2], zero });
+            const auto angularVelocities = DirectX::XMMatrixTranspose(DirectX::XMMATRIX{ angularVelocity[0], angularVelocity[1], angularVelocity[2], zero });
+
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                auto& spawn = m_Spawns[batch * 4 + lane];
+
+                DirectX::XMStoreFloat4A(&spawn.Position, positions.r[lane]);
+                DirectX::XMStoreFloat4A(&spawn.Velocity, velocities.r[lane]);
+                DirectX::XMStoreFloat4A(&spawn.Size, sizes.r[lane]);
+                DirectX::XMStoreFloat4A(&spawn.AngularVelocity, angularVelocities.r[lane]);
+            }
+        }
+
+        m_Spawns.resize(count);
+        return m_Spawns;
+    }
+}
\ No newline at end of file
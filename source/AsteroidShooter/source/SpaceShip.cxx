@@ -7,37 +7,36 @@
 #include <SpaceShip.hxx>
 #include <LaserBullet.hxx>
 #include <Game.hxx>
+#include <Core.World/Scene.hxx>
 
 namespace GameProject
 {
     using namespace Core;
 
-    SpaceShip::SpaceShip(World::Scene* scene, const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material, const Rendering::MeshRendererRef& bulletMesh, const Rendering::MaterialRendererRef& bulletMaterial) noexcept
+    SpaceShip::SpaceShip(const Rendering::MeshRendererRef& mesh, const Rendering::MaterialRendererRef& material, const Rendering::MeshRendererRef& bulletMesh, const Rendering::MaterialRendererRef& bulletMaterial, const LaserBulletPoolRef& bulletPool, LaserBulletMode bulletMode) noexcept
         : GameObject(SpaceShip::TypeID)
-        , m_Mesh{ mesh }
-        , m_Material{ material }
         , m_BulletMesh{ bulletMesh }
         , m_BulletMaterial{ bulletMaterial }
-        , m_Scene{ scene }
+        , m_BulletPool{ bulletPool }
+        , m_BulletMode{ bulletMode }
         , m_MoveVelocity{ 0.0F }
+        , m_TargetPosition{ 0.0F }
         , m_FireTimeout{ 0.0F }
         , m_CannonFlipFactor{ 1.0F }
     {
         //
-        // Create and setup rigid body.
+        // Ship is updated every frame and moved by scene as kinematic body.
         //
-        m_RigidBody = World::Physics::MakeRigidBody();
-        m_RigidBody->userData = reinterpret_cast<void*>(this);
-        m_RigidBody->setGlobalPose(physx::PxTransform::createIdentity());
-        m_RigidBody->setActorFlag(physx::PxActorFlag::eDISABLE_GRAVITY, false);
-        m_RigidBody->setRigidDynamicFlag(physx::PxRigidBodyFlag::eKINEMATIC, true);
-        m_RigidBody->setMass(10.0F);
+        m_ComponentFlags = World::ComponentFlags::Update | World::ComponentFlags::Kinematic;
+        m_Mesh = mesh;
+        m_Material = material;
 
         //
-        // And attach box shape.
+        // Unit box body starting at origin.
         //
-        auto shape = World::Physics::MakeBoxCollider(DirectX::XMVectorSet(0.5F, 0.5F, 0.5F, 0.0F));
-        m_RigidBody->attachShape(*shape);
+        m_Body.Extent = DirectX::XMFLOAT4A{ 0.5F, 0.5F, 0.5F, 0.0F };
+        m_Body.Layer = SpaceShip::Layer;
+        m_Body.IsEnabled = true;
     }
 
     SpaceShip::~SpaceShip() noexcept
@@ -55,12 +54,12 @@ namespace GameProject
 
             m_CannonFlipFactor *= -1.0F;
 
-            const auto position = World::Converters::PxVec3ToXMVECTOR(m_RigidBody->getGlobalPose().p);
+            const auto position = GetPosition();
             const auto direction = DirectX::XMVectorSet(m_CannonFlipFactor * 0.25F, 0.0F, 1.0F, 0.0F);
             const auto bulletPosition = DirectX::XMVectorAdd(position, DirectX::XMVectorScale(direction, 2.0F));
 
-            auto bullet = LaserBullet::Make(bulletPosition, direction, m_BulletMesh, m_BulletMaterial);
-            m_Scene->Add(bullet);
+            auto bullet = m_BulletPool->Acquire(bulletPosition, direction, m_BulletMode, m_BulletMesh, m_BulletMaterial);
+            GetScene()->Add(bullet);
         }
     }
 
@@ -71,44 +70,28 @@ namespace GameProject
         //
         // This is kinematic body, so we are responsible for moving it.
         //
-
-        const auto displacement = DirectX::XMVectorSet(m_MoveVelocity * deltaTime, 0.0F, 0.0F, 0.0F);
-
-        physx::PxVec3 pxDisplacement;
-        DirectX::XMStoreFloat3(reinterpret_cast<DirectX::XMFLOAT3*>(&pxDisplacement), displacement);
-
-        physx::PxTransform transform = m_RigidBody->getGlobalPose();
-        transform.p += pxDisplacement;
-
-        //
-        // Clamp to visible range.
+        // Target is accumulated here, because scene may not run simulation step every frame.
         //
-        transform.p.x = Core::Clamp(transform.p.x, -Game::VisibleRangeExtent, Game::VisibleRangeExtent);
-
-        m_RigidBody->setKinematicTarget(transform);
-    }
+        m_TargetPosition += m_MoveVelocity * deltaTime;
 
-    void SpaceShip::OnRender(const Rendering::CommandListRef& commandList) noexcept
-    {
         //
-        // Bind material.
+        // Clamp to visible range.
         //
-        m_Material->Bind(commandList);
+        m_TargetPosition = Core::Clamp(m_TargetPosition, -Game::VisibleRangeExtent, Game::VisibleRangeExtent);
 
         //
-        // And render mesh.
+        // Scene applies target before simulation step; rigid body can't be touched from here.
         //
-        m_Mesh->Bind(commandList);
-        m_Mesh->Render(commandList);
+        SetKinematicTarget(DirectX::XMVectorSet(m_TargetPosition, 0.0F, 0.0F, 0.0F));
     }
 
-    void SpaceShip::OnCollision(GameObject* other) noexcept
+    void SpaceShip::OnMeteoriteContact(World::GameObject* spaceShip, World::GameObject* meteorite) noexcept
     {
         //
         // When spaceship is destroyed, it resets game.
         //
-        other->Destroy();
-        Destroy();
+        meteorite->Destroy();
+        spaceShip->Destroy();
         Game::Current->Restart();
     }
 }
\ No newline at end of file
@@ -28,6 +28,12 @@ namespace Core::Diagnostics
         static bool AssertionFailed(const char* message, const char* function, const char* file, unsigned int line) noexcept;
     };
 
+#if defined(_WIN32)
+#define CORE_DEBUG_BREAK()                          ::DebugBreak()
+#else
+#define CORE_DEBUG_BREAK()                          __builtin_trap()
+#endif
+
 #ifdef NDEBUG
 
 #define CORE_ASSERT_MSG(_Expression, _Message)      ((void)0)
@@ -42,7 +48,7 @@ namespace Core::Diagnostics
         { \
             if (::Core::Diagnostics::Debug::AssertionFailed(_Message, __FUNCTION__, __FILE__, __LINE__) == false) \
             { \
-                ::DebugBreak(); \
+                CORE_DEBUG_BREAK(); \
             } \
         } \
     } while(false)
@@ -54,7 +60,7 @@ namespace Core::Diagnostics
         { \
             if (::Core::Diagnostics::Debug::AssertionFailed(nullptr, __FUNCTION__, __FILE__, __LINE__) == false) \
             { \
-                ::DebugBreak(); \
+                CORE_DEBUG_BREAK(); \
             } \
         } \
     } while(false)
@@ -51,7 +51,11 @@ namespace Core::Rendering
         Microsoft::WRL::ComPtr<ID3D11Buffer> m_Buffer;
 
     public:
-        VertexBuffer(RenderSystem* renderSystem, const BufferDesc& desc) noexcept;
+        //
+        // Dynamic buffer is rewritten by CommandList::UpdateVertexBuffer; its initial data is
+        // optional.
+        //
+        VertexBuffer(RenderSystem* renderSystem, const BufferDesc& desc, bool isDynamic) noexcept;
         virtual ~VertexBuffer() noexcept;
     };
 
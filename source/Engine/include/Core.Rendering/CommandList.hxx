@@ -15,6 +15,7 @@
 #include <Core.Rendering/Buffers.hxx>
 #include <Core.Rendering/Sampler.hxx>
 #include <Core.Rendering/Texture2D.hxx>
+#include <Core.Rendering/Viewport.hxx>
 
 namespace Core::Rendering
 {
@@ -29,19 +30,202 @@ namespace Core::Rendering
     CORE_ENUM_CLASS_FLAGS(ShaderMask);
 
 
+    //
+    // Number of state changes forwarded to device context and skipped as redundant.
+    //
+    struct CommandListCounter final
+    {
+        uint32_t Issued;
+        uint32_t Filtered;
+    };
+
+    struct CommandListStatistics final
+    {
+        CommandListCounter PipelineStates;
+        CommandListCounter UniformBuffers;
+        CommandListCounter VertexBuffers;
+        CommandListCounter IndexBuffers;
+        CommandListCounter Samplers;
+        CommandListCounter Textures;
+        uint32_t DrawCalls;
+
+        //
+        // Map / unmap round trips made to upload uniform data.
+        //
+        uint32_t UniformUploads;
+    };
+
+    //
+    // Slice of uniform ring. Data is written by caller and stays valid until next ring reset.
+    //
+    struct UniformAllocation final
+    {
+        void* Data;
+        uint32_t Page;
+        uint32_t Offset;
+        uint32_t Size;
+    };
+
     class RenderSystem;
 
     using CommandListRef = Reference<class CommandList>;
     class CommandList : public Resource
     {
+        friend class RenderSystem;
+
+    private:
+        static constexpr const uint32_t MaxUniformBuffers = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
+        static constexpr const uint32_t MaxVertexBuffers = D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT;
+        static constexpr const uint32_t MaxSamplers = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT;
+        static constexpr const uint32_t MaxTextures = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT;
+
+        //
+        // Uniform ring slices are aligned to 16 constants, as required by constant buffer offsets.
+        // Ring is made of pages of fixed size.
+        //
+        static constexpr const uint32_t UniformRingSize = 4U << 20;
+        static constexpr const uint32_t UniformAlignment = 256;
+        static constexpr const uint32_t MaxUniformSize = D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT * 16;
+
+        //
+        // Shadow of state bound to device context. Context holds references to bound objects, so
+        // raw pointers here can't dangle while they are bound.
+        //
+        struct BoundVertexBuffer
+        {
+            ID3D11Buffer* Buffer;
+            UINT Stride;
+            UINT Offset;
+        };
+
+        struct BoundUniformBuffer
+        {
+            ID3D11Buffer* Buffer;
+
+            //
+            // Range in constants; zero count binds whole buffer.
+            //
+            UINT FirstConstant;
+            UINT ConstantCount;
+
+            bool operator == (const BoundUniformBuffer& other) const noexcept
+            {
+                return Buffer == other.Buffer && FirstConstant == other.FirstConstant && ConstantCount == other.ConstantCount;
+            }
+        };
+
+        struct BoundState
+        {
+            ID3D11BlendState* BlendState;
+            ID3D11DepthStencilState* DepthStencilState;
+            ID3D11RasterizerState* RasterizerState;
+            ID3D11InputLayout* InputLayout;
+            D3D_PRIMITIVE_TOPOLOGY PrimitiveTopology;
+            ID3D11PixelShader* PixelShader;
+            ID3D11VertexShader* VertexShader;
+            BoundUniformBuffer PixelUniformBuffers[MaxUniformBuffers];
+            BoundUniformBuffer VertexUniformBuffers[MaxUniformBuffers];
+            BoundVertexBuffer VertexBuffers[MaxVertexBuffers];
+            ID3D11Buffer* IndexBuffer;
+            DXGI_FORMAT IndexFormat;
+            ID3D11SamplerState* PixelSamplers[MaxSamplers];
+            ID3D11ShaderResourceView* PixelTextures[MaxTextures];
+        };
+
     private:
         RenderSystem* m_RenderSystem;
         Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_Context;
+        BoundState m_Bound;
+        CommandListStatistics m_Statistics;
+
+        //
+        // Commands recorded on deferred context, waiting for execution.
+        //
+        Microsoft::WRL::ComPtr<ID3D11CommandList> m_Recorded;
+        bool m_IsDeferred;
+
+        //
+        // Uniform ring. With constant buffer offsetting each page is dynamic buffer, mapped once
+        // for all slices written between draws. Otherwise pages are staged in system memory and
+        // slices bound to each slot are uploaded to per slot buffers once before draw.
+        //
+        // Full page is never wrapped within frame, as slices written ahead of draws or still bound
+        // would be lost; next page is used instead and added when frame needs more of them.
+        //
+        Microsoft::WRL::ComPtr<ID3D11DeviceContext1> m_Context1;
+        std::vector<Microsoft::WRL::ComPtr<ID3D11Buffer>> m_UniformPages;
+        std::vector<std::vector<uint8_t>> m_UniformStaging;
+        Microsoft::WRL::ComPtr<ID3D11Buffer> m_FallbackUniforms[MaxUniformBuffers];
+        UniformAllocation m_FallbackSlices[MaxUniformBuffers];
+        uint32_t m_FallbackDirty;
+        uint8_t* m_UniformRingData;
+        uint32_t m_UniformPage;
+        uint32_t m_UniformRingOffset;
+        bool m_UniformRingDiscard;
 
     public:
         CommandList(RenderSystem* renderSystem, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context) noexcept;
         virtual ~CommandList() noexcept;
 
+        //
+        // Redundant state filtering.
+        //
+    public:
+        //
+        // Forgets shadowed state. Must be called when context state is changed outside of this
+        // command list.
+        //
+        void InvalidateState() noexcept;
+
+        const CommandListStatistics& GetStatistics() const noexcept
+        {
+            return m_Statistics;
+        }
+
+        void ResetStatistics() noexcept;
+
+        //
+        // Per frame uniform ring.
+        //
+    public:
+        //
+        // Starts new frame of uniform ring. Previous slices must not be bound anymore.
+        //
+        void ResetUniformRing() noexcept;
+
+        UniformAllocation AllocateUniforms(size_t size) noexcept;
+        void BindUniforms(ShaderMask mask, uint32_t index, const UniformAllocation& allocation) noexcept;
+
+        //
+        // Allocates slice, copies data to it and binds it.
+        //
+        void SetUniforms(ShaderMask mask, uint32_t index, const void* data, size_t size) noexcept;
+
+        //
+        // Deferred recording.
+        //
+    public:
+        bool IsDeferred() const noexcept
+        {
+            return m_IsDeferred;
+        }
+
+        //
+        // Closes recorded commands, so they may be executed by render system. Context state is
+        // cleared and recording of next batch may start right away.
+        //
+        void Finish() noexcept;
+
+        //
+        // Binds viewport render targets. Deferred contexts don't inherit them from immediate one.
+        //
+        void BindViewport(const ViewportRef& viewport) noexcept;
+
+    private:
+        void AddUniformPage() noexcept;
+        void SetUniformBinding(ShaderMask mask, uint32_t index, const BoundUniformBuffer& binding) noexcept;
+        void FlushUniforms() noexcept;
+
         //
         // Occlusion Query.
         //
@@ -90,6 +274,12 @@ namespace Core::Rendering
         //
     public:
         virtual void UpdateUniformBuffer(const UniformBufferRef& buffer, const void* data, size_t size) noexcept;
+
+        //
+        // Dynamic vertex buffer content update. Previous content is discarded.
+        //
+    public:
+        virtual void UpdateVertexBuffer(const VertexBufferRef& buffer, const void* data, size_t size) noexcept;
     };
 }
 
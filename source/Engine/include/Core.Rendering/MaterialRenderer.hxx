@@ -9,6 +9,22 @@
 
 #include <Core/Common.hxx>
 #include <Core/Reference.hxx>
+
+#if defined(CORE_HEADLESS)
+
+namespace Core::Rendering
+{
+    //
+    // Headless stand-in, see MeshRenderer.
+    //
+    using MaterialRendererRef = Reference<class MaterialRenderer>;
+    class MaterialRenderer final : public Object
+    {
+    };
+}
+
+#else
+
 #include <Core.Rendering/Common.hxx>
 #include <Core.Rendering/Buffers.hxx>
 #include <Core.Rendering/CommandList.hxx>
@@ -27,17 +43,51 @@ namespace Core::Rendering
         };
     private:
         ShaderParams m_ShaderParams;
-        UniformBufferRef m_ShaderParamsBuffer;
         GraphicsPipelineStateRef m_PipelineState;
+        GraphicsPipelineStateRef m_InstancedPipelineState;
         SamplerRef m_TextureSampler;
         Texture2DRef m_Texture;
 
     public:
-        MaterialRenderer(const std::string& pixelShader, const std::string& vertexShader) noexcept;
+        //
+        // Instanced vertex shader is optional. It reads world matrix of each instance from vertex
+        // buffer slot 1 instead of object uniform buffer.
+        //
+        MaterialRenderer(const std::string& pixelShader, const std::string& vertexShader, const std::string& instancedVertexShader = {}) noexcept;
         virtual ~MaterialRenderer() noexcept;
 
     public:
         void Bind(const Core::Rendering::CommandListRef& commandList) noexcept;
+        void BindInstanced(const Core::Rendering::CommandListRef& commandList) noexcept;
+
+        bool IsInstanced() const noexcept
+        {
+            return m_InstancedPipelineState != nullptr;
+        }
+
+        //
+        // Identifiers of state bound by material, for render queue keys.
+        //
+        uint32_t GetPipelineStateSortID(bool isInstanced) const noexcept
+        {
+            return (isInstanced ? m_InstancedPipelineState : m_PipelineState)->GetSortID();
+        }
+
+        uint32_t GetTextureSortID() const noexcept
+        {
+            return m_Texture != nullptr ? m_Texture->GetSortID() : 0;
+        }
+
+        //
+        // Each material owns its pipeline states, so it's identified by base one.
+        //
+        uint32_t GetSortID() const noexcept
+        {
+            return m_PipelineState->GetSortID();
+        }
+
+    private:
+        void Bind(const Core::Rendering::CommandListRef& commandList, const GraphicsPipelineStateRef& pipelineState) noexcept;
 
     public:
         ShaderParams& GetMaterialData() noexcept
@@ -62,4 +112,6 @@ namespace Core::Rendering
     };
 }
 
+#endif
+
 #endif // INCLUDED_CORE_RENDERING_MATERIALRENDERER_HXX
\ No newline at end of file
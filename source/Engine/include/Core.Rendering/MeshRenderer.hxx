@@ -9,6 +9,23 @@
 
 #include <Core/Common.hxx>
 #include <Core/Reference.hxx>
+
+#if defined(CORE_HEADLESS)
+
+namespace Core::Rendering
+{
+    //
+    // Headless builds never render. Gameplay code still passes mesh references around, so the
+    // type is kept, just without any GPU resources.
+    //
+    using MeshRendererRef = Reference<class MeshRenderer>;
+    class MeshRenderer final : public Object
+    {
+    };
+}
+
+#else
+
 #include <Core.Rendering/Buffers.hxx>
 #include <Core.Rendering/CommandList.hxx>
 
@@ -28,7 +45,19 @@ namespace Core::Rendering
     public:
         void Bind(const Rendering::CommandListRef& commandList) noexcept;
         void Render(const Rendering::CommandListRef& commandList) noexcept;
+
+        //
+        // Draws range of instances from instance buffer bound by caller.
+        //
+        void RenderInstanced(const Rendering::CommandListRef& commandList, uint32_t instanceCount, uint32_t startInstance) noexcept;
+
+        uint32_t GetSortID() const noexcept
+        {
+            return m_VertexBuffer->GetSortID();
+        }
     };
 }
 
+#endif
+
 #endif // INCLUDED_CORE_RENDERING_MESHRENDERER_HXX
\ No newline at end of file
@@ -0,0 +1,109 @@
+#ifndef INCLUDED_CORE_RENDERING_RENDERQUEUE_HXX
+#define INCLUDED_CORE_RENDERING_RENDERQUEUE_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+
+namespace Core::Rendering
+{
+    //
+    // Passes are submitted in order of their values.
+    //
+    enum class RenderPass : uint32_t
+    {
+        Opaque = 0,
+    };
+
+    //
+    // Layout of 64-bit draw sort key, from most significant field:
+    //
+    //      pass:4 | pipeline state:12 | texture:12 | material:12 | mesh:12 | depth:12
+    //
+    // Sorting keys groups draws by state which is most expensive to change and orders them front
+    // to back within group, so early depth test rejects most of overdraw. Identifiers are masked
+    // to field width; collisions only affect order, never correctness.
+    //
+    struct RenderKey final
+    {
+        static constexpr const uint32_t FieldBits = 12;
+        static constexpr const uint32_t FieldMask = (1U << FieldBits) - 1;
+        static constexpr const uint32_t DepthShift = 0;
+        static constexpr const uint32_t MeshShift = DepthShift + FieldBits;
+        static constexpr const uint32_t MaterialShift = MeshShift + FieldBits;
+        static constexpr const uint32_t TextureShift = MaterialShift + FieldBits;
+        static constexpr const uint32_t PipelineShift = TextureShift + FieldBits;
+        static constexpr const uint32_t PassShift = PipelineShift + FieldBits;
+
+        //
+        // Depth is normalized view distance in [0, 1].
+        //
+        static uint64_t Make(RenderPass pass, uint32_t pipeline, uint32_t texture, uint32_t material, uint32_t mesh, float depth) noexcept
+        {
+            const auto quantized = static_cast<uint32_t>(Clamp(depth, 0.0F, 1.0F) * static_cast<float>(FieldMask));
+
+            return (static_cast<uint64_t>(pass) << PassShift)
+                | (static_cast<uint64_t>(pipeline & FieldMask) << PipelineShift)
+                | (static_cast<uint64_t>(texture & FieldMask) << TextureShift)
+                | (static_cast<uint64_t>(material & FieldMask) << MaterialShift)
+                | (static_cast<uint64_t>(mesh & FieldMask) << MeshShift)
+                | (static_cast<uint64_t>(quantized) << DepthShift);
+        }
+    };
+
+    //
+    // Draws of single frame, sorted by key.
+    //
+    // Keys are sorted by LSD radix sort with 8-bit digits. Histograms of all digits are built in
+    // single pass and digits shared by all keys are skipped, so typical frame, where most of high
+    // fields are equal, takes only few passes.
+    //
+    class RenderQueue final
+    {
+    public:
+        struct Item
+        {
+            uint64_t Key;
+            uint32_t Index;
+        };
+
+    private:
+        std::vector<Item> m_Items;
+        std::vector<Item> m_Scratch;
+
+    public:
+        RenderQueue() noexcept;
+
+    public:
+        void Clear() noexcept
+        {
+            m_Items.clear();
+        }
+
+        void Push(uint64_t key, uint32_t index) noexcept
+        {
+            m_Items.push_back(Item{ key, index });
+        }
+
+        size_t GetCount() const noexcept
+        {
+            return m_Items.size();
+        }
+
+        const Item& operator[] (size_t index) const noexcept
+        {
+            return m_Items[index];
+        }
+
+        //
+        // Stable sort by key; draws with equal keys keep order of push.
+        //
+        void Sort() noexcept;
+    };
+}
+
+#endif // INCLUDED_CORE_RENDERING_RENDERQUEUE_HXX
\ No newline at end of file
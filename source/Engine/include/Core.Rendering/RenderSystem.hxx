@@ -41,6 +41,11 @@ namespace Core::Rendering
         Microsoft::WRL::ComPtr<IDXGIAdapter> m_DxgiAdapter;
         CommandListRef m_DefaultImmediateContext;
 
+        //
+        // Deferred command lists reused across frames, indexed by recording slot.
+        //
+        std::vector<CommandListRef> m_DeferredCommandLists;
+
         D3D_FEATURE_LEVEL m_CurrentFeatureLevel;
 
     public:
@@ -89,7 +94,7 @@ namespace Core::Rendering
         // Vertex buffer.
         //
     public:
-        virtual VertexBufferRef MakeVertexBuffer(const BufferDesc& desc) noexcept;
+        virtual VertexBufferRef MakeVertexBuffer(const BufferDesc& desc, bool isDynamic = false) noexcept;
         virtual IndexBufferRef MakeIndexBuffer(const BufferDesc& desc) noexcept;
         virtual UniformBufferRef MakeUniformBuffer(const BufferDesc& desc) noexcept;
 
@@ -106,6 +111,18 @@ namespace Core::Rendering
         virtual CommandListRef GetImmediateCommandList() noexcept;
         virtual CommandListRef MakeCommandList() noexcept;
 
+        //
+        // Returns pooled deferred command list. Pool grows on demand, so this must not be called
+        // while other threads record to pooled lists.
+        //
+        virtual CommandListRef GetDeferredCommandList(size_t index) noexcept;
+
+        //
+        // Executes commands recorded by finished deferred list on immediate context. Immediate
+        // context state is cleared afterwards, including render targets.
+        //
+        virtual void Execute(const CommandListRef& commandList) noexcept;
+
         //
         // Sampler.
         //
@@ -15,10 +15,22 @@ namespace Core::Rendering
 {
     class Resource : public Object
     {
+    private:
+        uint32_t m_SortID;
+
     public:
         Resource() noexcept;
         virtual ~Resource() noexcept;
 
+    public:
+        //
+        // Sequential number of resource, used to order draws by bound state. Wraps around.
+        //
+        uint32_t GetSortID() const noexcept
+        {
+            return m_SortID;
+        }
+
     protected:
         Resource(const Resource&) = delete;
         Resource& operator = (const Resource&) = delete;
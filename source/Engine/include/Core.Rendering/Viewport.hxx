@@ -21,6 +21,7 @@ namespace Core::Rendering
     class Viewport : public Resource
     {
         friend class RenderSystem;
+        friend class CommandList;
     private:
         RenderSystem* m_RenderSystem;
         Microsoft::WRL::ComPtr<IDXGISwapChain> m_SwapChain;
@@ -26,7 +26,8 @@ namespace Core::World
 
     private:
         ShaderParams m_ShaderParams;
-        Core::Rendering::UniformBufferRef m_ShaderParamsBuffer;
+        float m_NearZ;
+        float m_FarZ;
 
     public:
         Camera() noexcept;
@@ -36,6 +37,11 @@ namespace Core::World
         void XM_CALLCONV SetLens(float fov, float aspectRatio, float nearZ, float farZ) noexcept;
         void XM_CALLCONV LookAt(DirectX::FXMVECTOR position, DirectX::FXMVECTOR target, DirectX::FXMVECTOR up) noexcept;
 
+        //
+        // Linear view depth of point, normalized to [0, 1] between near and far plane.
+        //
+        float XM_CALLCONV GetNormalizedDepth(DirectX::FXMVECTOR position) const noexcept;
+
     public:
         void Bind(const Rendering::CommandListRef& commandList) noexcept;
     };
@@ -12,6 +12,38 @@
 
 namespace Core::World
 {
+    using GameObjectID = uint32_t;
+    using GameObjectTypeID = uint32_t;
+
+    //
+    // Object which is not added to any scene.
+    //
+    constexpr const GameObjectID InvalidGameObjectID = ~GameObjectID{ 0 };
+
+    //
+    // Collision layer of shape, in range [0, MaxCollisionLayers).
+    //
+    using CollisionLayer = uint32_t;
+    constexpr const CollisionLayer MaxCollisionLayers = 32;
+    constexpr const CollisionLayer DefaultCollisionLayer = 0;
+
+    //
+    // Simulation backend of scene.
+    //
+    enum class PhysicsBackend : uint32_t
+    {
+        //
+        // Full rigid body simulation in PhysX.
+        //
+        PhysX,
+
+        //
+        // Built-in simulation of boxes moving in horizontal plane. Bodies are integrated directly
+        // in component storage and only overlap and push each other apart; no joints, no
+        // friction, no stacking.
+        //
+        Planar,
+    };
 }
 
 #endif // INCLUDED_CORE_WORLD_COMMON_HXX
\ No newline at end of file
@@ -0,0 +1,173 @@
+#ifndef INCLUDED_CORE_WORLD_COMPONENTS_HXX
+#define INCLUDED_CORE_WORLD_COMPONENTS_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+#include <Core.World/Common.hxx>
+
+namespace physx
+{
+    class PxRigidDynamic;
+}
+
+namespace Core::World
+{
+    class GameObject;
+
+    enum class ComponentFlags : uint32_t
+    {
+        None = 0,
+
+        //
+        // Scene calls virtual GameObject::OnUpdate for this object.
+        //
+        Update = 1 << 0,
+
+        //
+        // Linear velocity from component storage is applied to rigid body before each simulation step.
+        //
+        DrivenVelocity = 1 << 1,
+
+        //
+        // Rigid body is kinematic and is moved to kinematic target from component storage before
+        // each simulation step.
+        //
+        Kinematic = 1 << 2,
+
+        //
+        // Rigid body moves only in horizontal plane at height where it was added to scene.
+        // Enforced by Physics after each simulation step.
+        //
+        PlanarMotion = 1 << 3,
+
+        //
+        // Object has rigid body simulated by scene physics backend. Set by scene from object body
+        // description.
+        //
+        RigidBody = 1 << 4,
+
+        //
+        // Object without rigid body which scene moves by its velocity each step. Path travelled
+        // in step is cast against spatial grid and first object hit on layer with
+        // CollisionResponse::Notify is reported as contact, so fast objects can't pass through
+        // thin ones. Objects on projectile's own layer are never hit.
+        //
+        Projectile = 1 << 5,
+    };
+    CORE_ENUM_CLASS_FLAGS(ComponentFlags);
+
+    //
+    // Backend independent description of rigid body with single box collider. Scene creates
+    // backend body from it when object is added.
+    //
+    struct RigidBodyDesc final
+    {
+        DirectX::XMFLOAT4A Position;
+        DirectX::XMFLOAT4A Orientation;
+        DirectX::XMFLOAT4A Velocity;
+        DirectX::XMFLOAT4A AngularVelocity;
+
+        //
+        // Half extent of box collider.
+        //
+        DirectX::XMFLOAT4A Extent;
+        CollisionLayer Layer;
+        bool IsEnabled;
+    };
+
+    //
+    // Structure-of-arrays storage for per object data.
+    //
+    // All arrays have the same length and are indexed by dense index resolved from GameObjectID
+    // through scene handle table. Scene keeps them compact, so update kernels can stream over
+    // them without chasing pointers to game objects.
+    //
+    class ComponentStorage final
+    {
+    public:
+        std::vector<GameObjectID> IDs;
+        std::vector<GameObject*> Objects;
+        std::vector<physx::PxRigidDynamic*> RigidBodies;
+        std::vector<GameObjectTypeID> Types;
+        std::vector<ComponentFlags> Flags;
+        std::vector<DirectX::XMFLOAT4A> Positions;
+        std::vector<DirectX::XMFLOAT4A> Orientations;
+        std::vector<DirectX::XMFLOAT4A> PreviousPositions;
+        std::vector<DirectX::XMFLOAT4A> PreviousOrientations;
+        std::vector<DirectX::XMFLOAT4A> Scales;
+        std::vector<DirectX::XMFLOAT4A> Velocities;
+        std::vector<DirectX::XMFLOAT4A> AngularVelocities;
+        std::vector<DirectX::XMFLOAT4A> Extents;
+        std::vector<DirectX::XMFLOAT4A> KinematicTargets;
+        std::vector<CollisionLayer> Layers;
+        std::vector<float> PlaneHeights;
+
+    public:
+        size_t GetCount() const noexcept
+        {
+            return Objects.size();
+        }
+
+        DirectX::XMMATRIX XM_CALLCONV GetTransform(size_t index) const noexcept
+        {
+            return DirectX::XMMatrixAffineTransformation(
+                DirectX::XMLoadFloat4A(&Scales[index]),
+                DirectX::XMVectorZero(),
+                DirectX::XMLoadFloat4A(&Orientations[index]),
+                DirectX::XMLoadFloat4A(&Positions[index])
+            );
+        }
+
+        //
+        // Blends between state before and after last simulation step.
+        //
+        DirectX::XMMATRIX XM_CALLCONV GetInterpolatedTransform(size_t index, float alpha) const noexcept
+        {
+            const auto position = DirectX::XMVectorLerp(
+                DirectX::XMLoadFloat4A(&PreviousPositions[index]),
+                DirectX::XMLoadFloat4A(&Positions[index]),
+                alpha
+            );
+
+            const auto orientation = DirectX::XMQuaternionSlerp(
+                DirectX::XMLoadFloat4A(&PreviousOrientations[index]),
+                DirectX::XMLoadFloat4A(&Orientations[index]),
+                alpha
+            );
+
+            return DirectX::XMMatrixAffineTransformation(
+                DirectX::XMLoadFloat4A(&Scales[index]),
+                DirectX::XMVectorZero(),
+                orientation,
+                position
+            );
+        }
+
+        //
+        // Captures current transforms as previous ones.
+        //
+        void StorePreviousTransforms() noexcept
+        {
+            PreviousPositions = Positions;
+            PreviousOrientations = Orientations;
+        }
+
+    public:
+        size_t Push(GameObject* object, physx::PxRigidDynamic* rigidBody, GameObjectTypeID typeID) noexcept;
+        void Move(size_t target, size_t source) noexcept;
+        void Resize(size_t count) noexcept;
+        void Clear() noexcept;
+    };
+
+    //
+    // Update kernel processes all objects of given type at once.
+    //
+    using UpdateKernel = void(*)(ComponentStorage& components, GameObjectTypeID typeID, float deltaTime);
+}
+
+#endif // INCLUDED_CORE_WORLD_COMPONENTS_HXX
\ No newline at end of file
@@ -8,26 +8,56 @@
 //
 
 #include <Core/Reference.hxx>
+#if !defined(CORE_HEADLESS)
 #include <Core.Rendering/CommandList.hxx>
+#endif
+#include <Core.Rendering/MaterialRenderer.hxx>
+#include <Core.Rendering/MeshRenderer.hxx>
 #include <Core/StringHash.hxx>
+#include <Core.World/Common.hxx>
+#include <Core.World/Components.hxx>
 #include <PxRigidDynamic.h>
 
 namespace Core::World
 {
-    using GameObjectID = uint32_t;
-    using GameObjectTypeID = uint32_t;
-
     using GameObjectRef = Reference<class GameObject>;
     class GameObject : public Object
     {
         friend class Scene;
-    protected:
+
+        template <typename T>
+        friend class GameObjectPool;
+    private:
+        //
+        // PhysX actor built by scene from body description. Object keeps it when removed from
+        // scene, so pooled objects reuse it.
+        //
         physx::PxRigidDynamic* m_RigidBody;
+        physx::PxShape* m_Shape;
+
+    protected:
+        //
+        // Initial component values. Scene copies them to component storage when object is added.
+        //
+        ComponentFlags m_ComponentFlags;
+        DirectX::XMFLOAT4A m_Scale;
+        float m_TimeToLive;
+        RigidBodyDesc m_Body;
+
+        //
+        // Scene draws objects sharing mesh and material with single instanced draw call, when
+        // material supports instancing. Other objects are drawn by OnRender.
+        //
+        Rendering::MeshRendererRef m_Mesh;
+        Rendering::MaterialRendererRef m_Material;
 
     public:
         const GameObjectTypeID TypeID;
        
     private:
+        class Scene* m_Scene;
+        class GameObjectPoolBase* m_Pool;
+        GameObjectID m_ID;
         bool m_MarkedToRemove;
 
     public:
@@ -36,15 +66,23 @@ namespace Core::World
 
     public:
         virtual void OnUpdate(float deltaTime) noexcept;
+#if !defined(CORE_HEADLESS)
         virtual void OnRender(const Rendering::CommandListRef& commandList) noexcept;
+#endif
         virtual void OnCollision(GameObject* other) noexcept;
         virtual void OnRemoveFromScene(physx::PxScene* scene) noexcept;
 
     public:
-        void Destroy() noexcept
-        {
-            m_MarkedToRemove = true;
-        }
+        //
+        // Marks object to be removed from scene. During parallel scene update request is deferred.
+        //
+        void Destroy() noexcept;
+
+    protected:
+        //
+        // Sets position of kinematic rigid body applied on next simulation step.
+        //
+        void XM_CALLCONV SetKinematicTarget(DirectX::FXMVECTOR position) noexcept;
 
     public:
         //
@@ -56,6 +94,16 @@ namespace Core::World
         {
             return m_MarkedToRemove;
         }
+
+        Scene* GetScene() const noexcept
+        {
+            return m_Scene;
+        }
+
+        GameObjectID GetID() const noexcept
+        {
+            return m_ID;
+        }
     };
 }
 
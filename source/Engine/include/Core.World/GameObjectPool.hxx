@@ -0,0 +1,102 @@
+#ifndef INCLUDED_CORE_WORLD_GAMEOBJECTPOOL_HXX
+#define INCLUDED_CORE_WORLD_GAMEOBJECTPOOL_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+#include <Core/Reference.hxx>
+#include <Core.Diagnostics/Debug.hxx>
+#include <Core.World/GameObject.hxx>
+
+namespace Core::World
+{
+    //
+    // Receives objects removed from scene.
+    //
+    class GameObjectPoolBase : public Object
+    {
+    public:
+        virtual void Release(GameObject* gameObject) noexcept = 0;
+    };
+
+    //
+    // Typed pool of game objects.
+    //
+    // Objects removed from scene are parked here together with their rigid body and shapes. Next
+    // acquire reinitializes parked object in place by calling:
+    //
+    //      void T::Reset(TArgs... args) noexcept;
+    //
+    // with the same arguments as T constructor.
+    //
+    template <typename T>
+    class GameObjectPool final : public GameObjectPoolBase
+    {
+        static_assert(std::is_base_of<GameObject, T>::value, "Only game objects can be pooled");
+
+    private:
+        std::vector<Reference<T>> m_Parked;
+        size_t m_CreatedCount;
+
+    public:
+        GameObjectPool() noexcept
+            : m_Parked{}
+            , m_CreatedCount{ 0 }
+        {
+        }
+
+        virtual ~GameObjectPool() noexcept
+        {
+            //
+            // Parked objects may outlive pool, make sure they don't try to come back.
+            //
+            for (auto& parked : m_Parked)
+            {
+                parked->m_Pool = nullptr;
+            }
+        }
+
+    public:
+        template <typename... TArgs>
+        Reference<T> Acquire(TArgs&&... args) noexcept
+        {
+            if (!m_Parked.empty())
+            {
+                auto result = std::move(m_Parked.back());
+                m_Parked.pop_back();
+
+                result->Reset(std::forward<TArgs>(args)...);
+                return result;
+            }
+
+            auto result = MakeRef<T>(std::forward<TArgs>(args)...);
+            result->m_Pool = this;
+            ++m_CreatedCount;
+            return result;
+        }
+
+        virtual void Release(GameObject* gameObject) noexcept override final
+        {
+            CORE_ASSERT(gameObject->GetScene() == nullptr);
+
+            m_Parked.push_back(Reference<T>{ static_cast<T*>(gameObject) });
+        }
+
+    public:
+        size_t GetCreatedCount() const noexcept
+        {
+            return m_CreatedCount;
+        }
+
+        size_t GetParkedCount() const noexcept
+        {
+            return m_Parked.size();
+        }
+    };
+}
+
+#endif // INCLUDED_CORE_WORLD_GAMEOBJECTPOOL_HXX
\ No newline at end of file
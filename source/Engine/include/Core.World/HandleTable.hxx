@@ -0,0 +1,121 @@
+#ifndef INCLUDED_CORE_WORLD_HANDLETABLE_HXX
+#define INCLUDED_CORE_WORLD_HANDLETABLE_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+#include <Core.Diagnostics/Debug.hxx>
+#include <Core.World/Common.hxx>
+
+namespace Core::World
+{
+    //
+    // Slot map translating stable GameObjectID handles to dense component indices.
+    //
+    // Handle layout:
+    //      [31..20] generation
+    //      [19..0]  slot index
+    //
+    // Generation is bumped every time slot is released, so handles held after object was removed
+    // from scene resolve to nothing instead of pointing to object which reused the slot.
+    //
+    // Slots keep full 32-bit generation; handle carries only its low bits. Long lived references
+    // which may outlast wrap of handle generation compare full generation as well.
+    //
+    class HandleTable final
+    {
+    public:
+        static constexpr const uint32_t IndexBits = 20;
+        static constexpr const uint32_t GenerationBits = 32 - IndexBits;
+        static constexpr const uint32_t IndexMask = (1U << IndexBits) - 1;
+        static constexpr const uint32_t GenerationMask = (1U << GenerationBits) - 1;
+
+        //
+        // Last slot index is reserved, so InvalidGameObjectID never resolves.
+        //
+        static constexpr const uint32_t MaxSlots = IndexMask;
+        static constexpr const uint32_t InvalidIndex = ~uint32_t{ 0 };
+
+    private:
+        struct Slot
+        {
+            uint32_t Dense;
+            uint32_t Generation;
+        };
+
+    private:
+        std::vector<Slot> m_Slots;
+        std::vector<uint32_t> m_FreeSlots;
+
+    public:
+        static uint32_t GetSlot(GameObjectID id) noexcept
+        {
+            return id & IndexMask;
+        }
+
+        static uint32_t GetGeneration(GameObjectID id) noexcept
+        {
+            return (id >> IndexBits) & GenerationMask;
+        }
+
+        static GameObjectID MakeID(uint32_t slot, uint32_t generation) noexcept
+        {
+            return ((generation & GenerationMask) << IndexBits) | (slot & IndexMask);
+        }
+
+    public:
+        GameObjectID Allocate(uint32_t dense) noexcept;
+        void Release(GameObjectID id) noexcept;
+        void Clear() noexcept;
+
+    public:
+        //
+        // Returns dense index of object or InvalidIndex when handle is stale.
+        //
+        uint32_t Resolve(GameObjectID id) const noexcept
+        {
+            const auto slot = GetSlot(id);
+
+            if (slot < m_Slots.size())
+            {
+                const auto& entry = m_Slots[slot];
+
+                if ((entry.Generation & GenerationMask) == GetGeneration(id))
+                {
+                    return entry.Dense;
+                }
+            }
+
+            return InvalidIndex;
+        }
+
+        bool IsValid(GameObjectID id) const noexcept
+        {
+            return Resolve(id) != InvalidIndex;
+        }
+
+        //
+        // Returns full generation of slot referenced by valid handle.
+        //
+        uint32_t GetFullGeneration(GameObjectID id) const noexcept
+        {
+            CORE_ASSERT(IsValid(id));
+            return m_Slots[GetSlot(id)].Generation;
+        }
+
+        //
+        // Updates dense index after object was moved in component storage.
+        //
+        void Update(GameObjectID id, uint32_t dense) noexcept
+        {
+            CORE_ASSERT(IsValid(id));
+            m_Slots[GetSlot(id)].Dense = dense;
+        }
+    };
+}
+
+#endif // INCLUDED_CORE_WORLD_HANDLETABLE_HXX
\ No newline at end of file
@@ -12,10 +12,30 @@
 #include <Core.World/Scene.hxx>
 #include <foundation/PxVec3.h>
 #include <foundation/PxMat44.h>
+#include <foundation/PxQuat.h>
 #include <PxPhysics.h>
 
 namespace Core::World
 {
+    enum class CollisionResponse : uint32_t
+    {
+        //
+        // Pair is dropped in broadphase; no contacts are generated.
+        //
+        None = 0,
+
+        //
+        // Solver resolves contacts between shapes.
+        //
+        Resolve = 1 << 0,
+
+        //
+        // Game objects are notified when shapes start touching.
+        //
+        Notify = 1 << 1,
+    };
+    CORE_ENUM_CLASS_FLAGS(CollisionResponse);
+
     class Physics final
     {
         friend class RigidBody;
@@ -29,14 +49,60 @@ namespace Core::World
         static void Shutdown() noexcept;
 
     public:
-        static Core::World::SceneRef MakeScene(const DirectX::XMFLOAT3& gravity) noexcept;
+        static Core::World::SceneRef MakeScene(const DirectX::XMFLOAT3& gravity, PhysicsBackend backend = PhysicsBackend::PhysX) noexcept;
+
+    public:
+        static physx::PxRigidDynamic* MakeRigidBody() noexcept;
+
+    public:
+        //
+        // Shapes are shared and interned by quantised geometry and material. Returned shape is owned
+        // by shape cache; actor takes its own reference when shape is attached.
+        //
+        // Null material means default material.
+        //
+        static physx::PxShape* MakeBoxCollider(DirectX::FXMVECTOR extent, CollisionLayer layer = DefaultCollisionLayer, physx::PxMaterial* material = nullptr) noexcept;
+        static physx::PxShape* MakeSphereCollider(float radius, CollisionLayer layer = DefaultCollisionLayer, physx::PxMaterial* material = nullptr) noexcept;
+
+        //
+        // Number of distinct shapes in cache.
+        //
+        static size_t GetCachedShapeCount() noexcept;
+
+        //
+        // Number of cached shapes attached to at least one actor.
+        //
+        static size_t GetLiveShapeCount() noexcept;
+
+        //
+        // Releases cached shapes which are not attached to any actor.
+        //
+        static size_t ReleaseUnusedShapes() noexcept;
 
     public:
-        static physx::PxRigidDynamic* Physics::MakeRigidBody() noexcept;
+        //
+        // Layer collision matrix. Matrix is symmetric and by default all layers resolve and report
+        // contacts with each other.
+        //
+        // Shapes carry only their layer bit in simulation filter data; matrix is copied to each
+        // PhysX scene as filter shader data when scene is made. Matrix is therefore frozen once
+        // first PhysX scene exists and must be set up before. Planar backend reads it directly.
+        //
+        static void SetCollisionResponse(CollisionLayer layer0, CollisionLayer layer1, CollisionResponse response) noexcept;
+        static CollisionResponse GetCollisionResponse(CollisionLayer layer0, CollisionLayer layer1) noexcept;
+
+        //
+        // Returns row of collision matrix: bit N is set when layer has given response with layer N.
+        //
+        static uint32_t GetCollisionMask(CollisionLayer layer, CollisionResponse response) noexcept;
 
     public:
-        static physx::PxShape* MakeBoxCollider(DirectX::FXMVECTOR extent) noexcept;
-        static physx::PxShape* MakeSphereCollider(float radius) noexcept;
+        //
+        // Projects bodies with ComponentFlags::PlanarMotion back to their planes: removes vertical
+        // drift and vertical velocity introduced by solver. Runs once per step over whole storage,
+        // so planar bodies need neither joints nor per object velocity fixups.
+        //
+        static void ApplyPlanarConstraints(ComponentStorage& components) noexcept;
 
     public:
         static physx::PxMaterial* GetDefaultMaterial() noexcept;
@@ -51,6 +117,9 @@ namespace Core::World
         static_assert(sizeof(DirectX::XMFLOAT3) == sizeof(physx::PxVec3), "I really do miss C++17 static assert without message...");
         static_assert(alignof(DirectX::XMFLOAT3) <= alignof(physx::PxVec3), "I really do miss C++17 static assert without message...");
 
+        static_assert(sizeof(DirectX::XMFLOAT4) == sizeof(physx::PxQuat), "I really do miss C++17 static assert without message...");
+        static_assert(alignof(DirectX::XMFLOAT4) <= alignof(physx::PxQuat), "I really do miss C++17 static assert without message...");
+
 
         __forceinline physx::PxMat44 XM_CALLCONV XMMATRIXToPxMatrix(DirectX::FXMMATRIX m) noexcept
         {
@@ -77,6 +146,18 @@ namespace Core::World
             return DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(&v));
         }
 
+        __forceinline physx::PxQuat XM_CALLCONV XMVECTORToPxQuat(DirectX::FXMVECTOR v) noexcept
+        {
+            physx::PxQuat result;
+            DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(&result), v);
+            return result;
+        }
+
+        __forceinline DirectX::XMVECTOR XM_CALLCONV PxQuatToXMVECTOR(const physx::PxQuat& v) noexcept
+        {
+            return DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&v));
+        }
+
         __forceinline physx::PxTransform XM_CALLCONV XMMATRIXToPxTransform(DirectX::FXMMATRIX t) noexcept
         {
             physx::PxMat44 px;
@@ -0,0 +1,134 @@
+#ifndef INCLUDED_CORE_WORLD_PLANARPHYSICS_HXX
+#define INCLUDED_CORE_WORLD_PLANARPHYSICS_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+#include <Core.World/Common.hxx>
+#include <Core.World/Components.hxx>
+
+namespace Core::World
+{
+    //
+    // Physics backend for boxes moving in horizontal plane.
+    //
+    // Body state lives in component storage; backend keeps only per step scratch arrays in
+    // structure-of-arrays form. Each step:
+    //
+    //      1. integrates positions and orientations,
+    //      2. computes footprint of each collider in XZ plane as oriented box,
+    //      3. finds pairs with overlapping bounds by sort-and-sweep along X axis,
+    //      4. runs separating axis test on candidate pairs, four pairs at a time,
+    //      5. pushes apart pairs with CollisionResponse::Resolve and reports pairs with
+    //         CollisionResponse::Notify which started touching in this step.
+    //
+    // Footprint uses box extents along its local X and Z axes; tilt out of plane is ignored.
+    //
+    class PlanarPhysics final
+    {
+    public:
+        struct Contact
+        {
+            GameObjectID First;
+            GameObjectID Second;
+        };
+
+    private:
+        //
+        // Number of items processed by single job.
+        //
+        static constexpr const size_t IntegrateGrainSize = 1024;
+        static constexpr const size_t SweepGrainSize = 512;
+        static constexpr const size_t NarrowphaseGrainSize = 256;
+        static_assert((NarrowphaseGrainSize % 4) == 0, "Narrowphase processes pairs in batches of four");
+
+        static constexpr const float Restitution = 0.1F;
+
+        //
+        // Pair of collider slots which bounds overlap.
+        //
+        struct Candidate
+        {
+            uint32_t First;
+            uint32_t Second;
+        };
+
+        //
+        // Penetration of overlapping pair. Normal points from first to second collider.
+        //
+        struct Manifold
+        {
+            uint32_t First;
+            uint32_t Second;
+            float NormalX;
+            float NormalZ;
+            float Depth;
+        };
+
+    private:
+        DirectX::XMFLOAT3 m_Gravity;
+
+        //
+        // Colliders taking part in current step, indexed by slot.
+        //
+        std::vector<uint32_t> m_Indices;
+        std::vector<float> m_CenterX;
+        std::vector<float> m_CenterZ;
+        std::vector<float> m_AxisX;
+        std::vector<float> m_AxisZ;
+        std::vector<float> m_ExtentX;
+        std::vector<float> m_ExtentZ;
+        std::vector<float> m_InverseMass;
+        std::vector<uint32_t> m_LayerBits;
+        std::vector<uint32_t> m_ResolveMasks;
+        std::vector<uint32_t> m_NotifyMasks;
+
+        //
+        // Bounds in sweep order.
+        //
+        std::vector<std::pair<float, uint32_t>> m_SortKeys;
+        std::vector<float> m_SortedMinX;
+        std::vector<float> m_SortedMaxX;
+        std::vector<float> m_SortedMinZ;
+        std::vector<float> m_SortedMaxZ;
+        std::vector<float> m_MinZ;
+        std::vector<float> m_MaxZ;
+        std::vector<float> m_MaxX;
+
+        //
+        // Results of parallel phases, one buffer per chunk, so merged order is deterministic.
+        //
+        std::vector<std::vector<Candidate>> m_ChunkCandidates;
+        std::vector<std::vector<Manifold>> m_ChunkManifolds;
+        std::vector<Candidate> m_Candidates;
+
+        //
+        // Pairs touching in current and previous step, as sorted keys of object IDs.
+        //
+        std::vector<uint64_t> m_Touching;
+        std::vector<uint64_t> m_PreviousTouching;
+
+    public:
+        explicit PlanarPhysics(const DirectX::XMFLOAT3& gravity) noexcept;
+
+    public:
+        //
+        // Advances all bodies with ComponentFlags::RigidBody by single step and appends contacts
+        // which started in this step.
+        //
+        void Simulate(ComponentStorage& components, float deltaTime, std::vector<Contact>& contacts) noexcept;
+
+    private:
+        void Integrate(ComponentStorage& components, float deltaTime) noexcept;
+        void BuildColliders(const ComponentStorage& components) noexcept;
+        void FindCandidates() noexcept;
+        void TestCandidates() noexcept;
+        void ResolveContacts(ComponentStorage& components, std::vector<Contact>& contacts) noexcept;
+    };
+}
+
+#endif // INCLUDED_CORE_WORLD_PLANARPHYSICS_HXX
\ No newline at end of file
@@ -10,7 +10,15 @@
 #include <Core/Common.hxx>
 #include <Core/Reference.hxx>
 #include <Core.World/GameObject.hxx>
+#include <Core.World/Components.hxx>
+#include <Core.World/HandleTable.hxx>
+#include <Core.World/PlanarPhysics.hxx>
+#include <Core.World/SpatialGrid.hxx>
+#include <Core.World/TimingWheel.hxx>
+#if !defined(CORE_HEADLESS)
 #include <Core.World/Camera.hxx>
+#include <Core.Rendering/RenderQueue.hxx>
+#endif
 
 #include <PxPhysics.h>
 #include <PxScene.h>
@@ -18,14 +26,29 @@
 
 namespace Core::World
 {
+    //
+    // Handles contact between objects of registered type pair. Objects are passed in the same order
+    // as types given on registration.
+    //
+    using ContactHandler = void(*)(GameObject* first, GameObject* second);
+
     using SceneRef = Reference<class Scene>;
     class Scene : public Object, private physx::PxSimulationEventCallback
     {
         friend class Physics;
+        friend class GameObject;
 
-    private:
+    public:
         static constexpr const float FixedDeltaTime = 0.02F;
+        static constexpr const uint32_t DefaultMaxSubsteps = 5;
 
+    private:
+        //
+        // Number of objects updated by single job.
+        //
+        static constexpr const size_t UpdateGrainSize = 64;
+
+#if !defined(CORE_HEADLESS)
     private:
         //
         // Scene params for GPU.
@@ -45,48 +68,343 @@ namespace Core::World
         };
         static_assert(alignof(SceneParams) >= alignof(DirectX::XMVECTOR), "");
 
+        //
+        // Per instance vertex data. Matches layout of instanced vertex shaders.
+        //
+        struct InstanceData
+        {
+            DirectX::XMFLOAT4X4 World;
+        };
+
+        static constexpr const size_t InitialInstanceCapacity = 256;
+
+        //
+        // Contiguous range of sorted render queue recorded by single deferred command list.
+        //
+        struct RenderBatch
+        {
+            size_t First;
+            size_t Last;
+            uint32_t Instance;
+            Core::Rendering::CommandListRef CommandList;
+        };
+
+        //
+        // Scenes with fewer objects per worker are recorded directly, as deferred lists don't pay
+        // off for them.
+        //
+        static constexpr const size_t MinRenderBatchSize = 256;
+#endif
+
     private:
+        //
+        // PhysX scene; null when scene uses planar backend.
+        //
         physx::PxScene* m_Scene;
         physx::PxPhysics* m_Physics;
+        std::unique_ptr<PlanarPhysics> m_Planar;
+        std::vector<PlanarPhysics::Contact> m_PlanarContacts;
 
+        //
+        // Keeps objects alive. Indexed by GameObjectID, parallel to component storage.
+        //
         std::vector<GameObjectRef> m_Objects;
+        ComponentStorage m_Components;
+        HandleTable m_Handles;
+
+        std::vector<std::pair<GameObjectTypeID, UpdateKernel>> m_UpdateKernels;
+
+        //
+        // Rebuilt after each simulation step.
+        //
+        SpatialGrid m_SpatialGrid;
+
+        //
+        // Objects with limited time to live, in fixed steps.
+        //
+        TimingWheel m_Expiry;
+        std::vector<TimingWheel::Timer> m_Expired;
+
+        //
+        // Ray casts of projectiles in current step.
+        //
+        std::vector<uint32_t> m_ProjectileIndices;
+        std::vector<RayQuery> m_ProjectileRays;
+        std::vector<RayHit> m_ProjectileHits;
+
+    private:
+        //
+        // Contact reported by physics. Recorded during fetch and dispatched after it.
+        //
+        struct ContactEvent
+        {
+            uint64_t TypePair;
+            GameObjectID First;
+            GameObjectID Second;
+        };
+
+        struct ContactHandlerEntry
+        {
+            uint64_t TypePair;
+            ContactHandler Handler;
+            bool IsSwapped;
+        };
+
+        //
+        // Handlers are sorted by type pair, so dispatch may walk them together with sorted contacts.
+        //
+        std::vector<ContactHandlerEntry> m_ContactHandlers;
+        std::vector<ContactEvent> m_Contacts;
+
+    private:
+        //
+        // Structural change requested during parallel update.
+        //
+        struct DeferredCommand
+        {
+            //
+            // Index of object which issued command and sequence number within that object. Commands
+            // are applied in this order, so result doesn't depend on thread scheduling.
+            //
+            uint64_t Order;
+            GameObjectRef Object;
+            bool IsSpawn;
+        };
+
+        struct alignas(64) CommandBuffer
+        {
+            std::vector<DeferredCommand> Commands;
+            uint64_t CurrentObject;
+            uint32_t Sequence;
+        };
+
+        std::vector<CommandBuffer> m_CommandBuffers;
+        std::vector<DeferredCommand> m_PendingCommands;
+        bool m_IsUpdating;
 
+        //
+        // Objects destroyed since last removal, in order of destruction.
+        //
+        std::vector<GameObjectID> m_PendingRemovals;
+        std::vector<physx::PxActor*> m_RemovedActors;
+
+#if !defined(CORE_HEADLESS)
         Core::World::CameraRef m_Camera;
-        Core::Rendering::UniformBufferRef m_CurrentObject;
 
-        SceneParams m_SceneParams;
+        //
+        // Params of objects drawn one by one, allocated from command list uniform ring each frame.
+        //
+        std::vector<Core::Rendering::UniformAllocation> m_ObjectUniforms;
+
+        //
+        // Draws of objects sorted by state and depth. Instance buffer is rewritten every frame and
+        // grows when needed.
+        //
+        Core::Rendering::RenderQueue m_RenderQueue;
+        std::vector<InstanceData> m_InstanceData;
+        Core::Rendering::VertexBufferRef m_InstanceBuffer;
+        size_t m_InstanceCapacity;
+
+        //
+        // Objects without mesh or material, rendered before render queue.
+        //
+        std::vector<uint32_t> m_UnsortedObjects;
+        std::vector<RenderBatch> m_RenderBatches;
+#endif
+
+        //
+        // Simulated time not consumed by fixed steps yet.
+        //
+        float m_Accumulator;
+        float m_InterpolationAlpha;
+        uint32_t m_MaxSubsteps;
+
+        //
+        // In asynchronous mode last step of tick is left running and fetched on next frame.
+        //
+        bool m_IsSimulationAsync;
+        bool m_IsSimulating;
 
     public:
         Scene(physx::PxPhysics* physics, physx::PxSceneDesc scene) noexcept;
+
+        //
+        // Creates scene simulated by planar backend.
+        //
+        explicit Scene(const DirectX::XMFLOAT3& gravity) noexcept;
         virtual ~Scene() noexcept;
 
+    private:
+        void CreateResources() noexcept;
+
     public:
+#if !defined(CORE_HEADLESS)
         Core::World::CameraRef GetCamera() const noexcept
         {
             return m_Camera;
         }
+#endif
+
+        PhysicsBackend GetBackend() const noexcept
+        {
+            return (m_Planar != nullptr) ? PhysicsBackend::Planar : PhysicsBackend::PhysX;
+        }
 
         size_t GetObjectsCount() const noexcept
         {
             return m_Objects.size();
         }
 
+        const ComponentStorage& GetComponents() const noexcept
+        {
+            return m_Components;
+        }
+
+        //
+        // Spatial index of objects at the end of last simulation step. Safe to query from update
+        // kernels and object updates. Objects destroyed by contacts of that step stay in it until
+        // next one; their handles resolve to nullptr.
+        //
+        const SpatialGrid& GetSpatialGrid() const noexcept
+        {
+            return m_SpatialGrid;
+        }
+
+        void SetSpatialCellSize(float value) noexcept
+        {
+            m_SpatialGrid.SetCellSize(value);
+        }
+
+        //
+        // Returns true when scene runs object updates; structural changes are deferred then.
+        //
+        bool IsUpdating() const noexcept
+        {
+            return m_IsUpdating;
+        }
+
+        //
+        // Resolves handle to index in component storage. Stale handles resolve to HandleTable::InvalidIndex.
+        //
+        uint32_t GetComponentIndex(GameObjectID id) const noexcept
+        {
+            return m_Handles.Resolve(id);
+        }
+
+        //
+        // Resolves handle to game object. Stale handles resolve to nullptr.
+        //
+        GameObject* Resolve(GameObjectID id) const noexcept
+        {
+            const auto index = m_Handles.Resolve(id);
+
+            if (index != HandleTable::InvalidIndex)
+            {
+                return m_Components.Objects[index];
+            }
+
+            return nullptr;
+        }
+
         void Clear() noexcept;
 
+        //
+        // Limits number of fixed steps per tick. Remaining time is dropped, so slow frames don't
+        // spiral into even slower ones.
+        //
+        void SetMaxSubsteps(uint32_t value) noexcept
+        {
+            CORE_ASSERT(value > 0);
+            m_MaxSubsteps = value;
+        }
+
+        uint32_t GetMaxSubsteps() const noexcept
+        {
+            return m_MaxSubsteps;
+        }
+
+        //
+        // Fraction of fixed step between last two simulated states used for rendering.
+        //
+        float GetInterpolationAlpha() const noexcept
+        {
+            return m_InterpolationAlpha;
+        }
+
+        //
+        // Enables overlapping of physics simulation with gameplay and rendering.
+        //
+        // Rendering uses transforms from last fetched step, so it lags by one fixed step.
+        //
+        void SetAsyncSimulation(bool value) noexcept;
+
+        bool IsAsyncSimulation() const noexcept
+        {
+            return m_IsSimulationAsync;
+        }
+
+        //
+        // Registers kernel called once per update for all objects of given type.
+        //
+        void RegisterUpdateKernel(GameObjectTypeID typeID, UpdateKernel kernel) noexcept;
+
+        //
+        // Registers handler called for each contact between objects of given types. Contacts without
+        // handler fall back to GameObject::OnCollision on both objects.
+        //
+        void RegisterContactHandler(GameObjectTypeID first, GameObjectTypeID second, ContactHandler handler) noexcept;
+
+#if !defined(CORE_HEADLESS)
     private:
-        void RenderSingleObject(const World::GameObjectRef& gameObject, const Rendering::CommandListRef& commandList) noexcept;
+        void WriteObjectUniforms(size_t index, const Rendering::CommandListRef& commandList) noexcept;
+        void RenderSingleObject(size_t index, const Rendering::CommandListRef& commandList) noexcept;
+        void PrepareRenderQueue() noexcept;
+        void UploadInstanceData(const Rendering::CommandListRef& commandList) noexcept;
+        void RenderUnsortedObjects(const Rendering::CommandListRef& commandList) noexcept;
+        void SubmitRenderQueue(const Rendering::CommandListRef& commandList, size_t first, size_t last, uint32_t instance) noexcept;
+#endif
 
     public:
         void OnUpdate(float deltaTime) noexcept;
+#if !defined(CORE_HEADLESS)
         void OnRender(const Rendering::CommandListRef& commandList) noexcept;
 
+        //
+        // Splits sorted draws across job workers, each recording its own deferred command list,
+        // and executes lists in queue order on given immediate command list. Objects' OnRender
+        // may therefore run concurrently.
+        //
+        void OnRender(const Rendering::CommandListRef& commandList, const Rendering::ViewportRef& viewport) noexcept;
+#endif
+
     public:
         void Add(const GameObjectRef& gameObject) noexcept;
         void Remove(const GameObjectRef& gameObject) noexcept;
         void Tick(float deltaTime) noexcept;
 
+        //
+        // Waits for step started by previous tick, if any. Should be called at the beginning of the
+        // frame, before any gameplay code touches scene.
+        //
+        void FetchResults() noexcept;
+
+    private:
+        void DeferDestroy(GameObject* gameObject) noexcept;
+        void PushCommand(GameObject* gameObject, bool isSpawn) noexcept;
+        void ApplyDeferredCommands() noexcept;
+
     private:
+        void Step() noexcept;
+        void BeginStep() noexcept;
+        void EndStep() noexcept;
         void RemovePendingObjects() noexcept;
+        void RemoveAt(size_t index) noexcept;
+        void AddRigidBody(GameObject* gameObject, size_t index) noexcept;
+        void ExpireObjects() noexcept;
+        void AdvanceProjectiles() noexcept;
+        void SyncToPhysics() noexcept;
+        void SyncFromPhysics() noexcept;
+        void DispatchContacts() noexcept;
 
     private:
         virtual void onConstraintBreak(physx::PxConstraintInfo* constraints, physx::PxU32 count) override final;
@@ -0,0 +1,208 @@
+#ifndef INCLUDED_CORE_WORLD_SPATIALGRID_HXX
+#define INCLUDED_CORE_WORLD_SPATIALGRID_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+#include <Core.World/Common.hxx>
+#include <Core.World/Components.hxx>
+
+namespace Core::World
+{
+    //
+    // Objects within radius of center.
+    //
+    struct RadiusQuery final
+    {
+        DirectX::XMFLOAT3 Center;
+        float Radius;
+
+        //
+        // Bit mask of collision layers to report.
+        //
+        uint32_t LayerMask;
+    };
+
+    //
+    // Objects overlapping axis aligned box.
+    //
+    struct BoundsQuery final
+    {
+        DirectX::XMFLOAT3 Min;
+        DirectX::XMFLOAT3 Max;
+        uint32_t LayerMask;
+    };
+
+    //
+    // Nearest object along ray.
+    //
+    struct RayQuery final
+    {
+        DirectX::XMFLOAT3 Origin;
+        DirectX::XMFLOAT3 Direction;
+        float MaxDistance;
+        uint32_t LayerMask;
+    };
+
+    struct RayHit final
+    {
+        //
+        // InvalidGameObjectID and query MaxDistance when ray hit nothing.
+        //
+        GameObjectID Object;
+        float Distance;
+    };
+
+    //
+    // Objects reported by batch of radius or bounds queries.
+    //
+    // Hits of query `i` are stored in range [Offsets[i], Offsets[i + 1]) of Objects. Results may be
+    // reused between batches to avoid reallocations.
+    //
+    class SpatialQueryResults final
+    {
+        friend class SpatialGrid;
+
+    public:
+        std::vector<uint32_t> Offsets;
+        std::vector<GameObjectID> Objects;
+
+    private:
+        std::vector<std::vector<GameObjectID>> m_Chunks;
+
+    public:
+        size_t GetHitsCount(size_t query) const noexcept
+        {
+            return Offsets[query + 1] - Offsets[query];
+        }
+
+        const GameObjectID* GetHits(size_t query) const noexcept
+        {
+            return Objects.data() + Offsets[query];
+        }
+    };
+
+    //
+    // Hashed uniform grid over object positions in horizontal plane.
+    //
+    // Each object is bounded by circle enclosing its collider extents in XZ plane and is inserted
+    // into every cell the circle overlaps. Cells are hashed into buckets and entries are sorted by
+    // bucket with counting sort, so grid is rebuilt from scratch in linear time and has no
+    // bounds on world size. Height is ignored by all queries.
+    //
+    // Grid holds copy of positions taken at build time; it is read only between builds, so any
+    // number of threads may query it at once.
+    //
+    class SpatialGrid final
+    {
+    public:
+        static constexpr const float DefaultCellSize = 4.0F;
+
+    private:
+        //
+        // Number of items processed by single job.
+        //
+        static constexpr const size_t BuildGrainSize = 1024;
+        static constexpr const size_t QueryGrainSize = 64;
+
+        static constexpr const uint32_t MinBucketBits = 4;
+        static constexpr const uint32_t MaxBucketBits = 24;
+
+        //
+        // Range of cells overlapped by object or query, inclusive.
+        //
+        struct CellRange
+        {
+            int32_t MinX;
+            int32_t MinZ;
+            int32_t MaxX;
+            int32_t MaxZ;
+        };
+
+    private:
+        float m_CellSize;
+        float m_InverseCellSize;
+
+        //
+        // Objects taking part in current build, indexed by slot.
+        //
+        std::vector<GameObjectID> m_IDs;
+        std::vector<float> m_CenterX;
+        std::vector<float> m_CenterZ;
+        std::vector<float> m_Radius;
+        std::vector<uint32_t> m_LayerBits;
+        std::vector<CellRange> m_Cells;
+        std::vector<uint32_t> m_EntryOffsets;
+
+        //
+        // Object slot and cell key of each entry, sorted by bucket.
+        //
+        std::vector<uint32_t> m_BucketStart;
+        std::vector<uint32_t> m_EntryObjects;
+        std::vector<uint64_t> m_EntryCells;
+        std::vector<uint32_t> m_UnsortedObjects;
+        std::vector<uint64_t> m_UnsortedCells;
+        uint32_t m_BucketShift;
+
+    public:
+        SpatialGrid() noexcept;
+
+    public:
+        //
+        // Cell size should be close to typical query radius and larger than most objects. Takes
+        // effect on next build.
+        //
+        void SetCellSize(float value) noexcept;
+
+        float GetCellSize() const noexcept
+        {
+            return m_CellSize;
+        }
+
+        size_t GetObjectsCount() const noexcept
+        {
+            return m_IDs.size();
+        }
+
+        void Build(const ComponentStorage& components) noexcept;
+        void Clear() noexcept;
+
+    public:
+        //
+        // Runs batch of queries in parallel. Hits of single query are reported in deterministic
+        // order.
+        //
+        void QueryRadius(const RadiusQuery* queries, size_t count, SpatialQueryResults& results) const noexcept;
+        void QueryBounds(const BoundsQuery* queries, size_t count, SpatialQueryResults& results) const noexcept;
+
+        //
+        // Writes nearest hit of each ray to hits. Direction doesn't have to be normalized; rays
+        // with zero direction in XZ plane hit nothing. MaxDistance must be finite.
+        //
+        void CastRays(const RayQuery* queries, size_t count, RayHit* hits) const noexcept;
+
+    private:
+        CellRange GetCellRange(float minX, float minZ, float maxX, float maxZ) const noexcept;
+        uint32_t GetBucket(uint64_t cell) const noexcept;
+
+        //
+        // Calls function(slot) once for each object which cell range overlaps given one.
+        //
+        template <typename TFunction>
+        void ForEachCandidate(const CellRange& range, TFunction&& function) const noexcept;
+
+        //
+        // Calls function(query, hits) for each query and gathers hits of all queries.
+        //
+        template <typename TQuery, typename TFunction>
+        void RunQueries(const TQuery* queries, size_t count, SpatialQueryResults& results, TFunction&& function) const noexcept;
+
+        RayHit CastRay(const RayQuery& query) const noexcept;
+    };
+}
+
+#endif // INCLUDED_CORE_WORLD_SPATIALGRID_HXX
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef INCLUDED_CORE_WORLD_TIMINGWHEEL_HXX
+#define INCLUDED_CORE_WORLD_TIMINGWHEEL_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+#include <Core.World/Common.hxx>
+
+namespace Core::World
+{
+    //
+    // Hierarchical timing wheel of object expiry ticks.
+    //
+    // Level `n` has SlotsPerLevel slots, each spanning SlotsPerLevel^n ticks. Timer is placed on
+    // the lowest level which covers its distance from current tick. When level 0 wraps around,
+    // next slot of level above is cascaded down; timers are therefore moved at most once per
+    // level and advancing by one tick touches only expiring slot.
+    //
+    // Timers further than horizon are parked in the farthest slot and rescheduled on cascade.
+    //
+    class TimingWheel final
+    {
+    public:
+        static constexpr const uint32_t LevelBits = 6;
+        static constexpr const uint32_t SlotsPerLevel = 1U << LevelBits;
+        static constexpr const uint32_t LevelCount = 4;
+        static constexpr const uint64_t Horizon = uint64_t{ 1 } << (LevelBits * LevelCount);
+
+        struct Timer
+        {
+            uint64_t Expiry;
+            GameObjectID Object;
+
+            //
+            // Full generation of object's handle slot when timer was scheduled. Handle keeps only
+            // few low bits of it, which may wrap while timer is pending.
+            //
+            uint32_t Generation;
+        };
+
+    private:
+        std::vector<Timer> m_Slots[LevelCount][SlotsPerLevel];
+        std::vector<Timer> m_Cascade;
+        uint64_t m_CurrentTick;
+        size_t m_Count;
+
+    public:
+        TimingWheel() noexcept;
+
+    public:
+        uint64_t GetCurrentTick() const noexcept
+        {
+            return m_CurrentTick;
+        }
+
+        size_t GetCount() const noexcept
+        {
+            return m_Count;
+        }
+
+        //
+        // Schedules object to expire given number of ticks from now. Zero delay expires on next tick.
+        //
+        void Schedule(GameObjectID object, uint32_t generation, uint64_t delay) noexcept;
+
+        //
+        // Advances by single tick and appends timers which expired to given list.
+        //
+        void Advance(std::vector<Timer>& expired) noexcept;
+
+        //
+        // Drops all timers. Current tick is preserved.
+        //
+        void Clear() noexcept;
+
+    private:
+        void Insert(const Timer& timer) noexcept;
+    };
+}
+
+#endif // INCLUDED_CORE_WORLD_TIMINGWHEEL_HXX
\ No newline at end of file
@@ -23,10 +23,25 @@
 #include <type_traits>
 #include <vector>
 
+//
+// Headless builds run simulation only: no window, no render system and no Direct3D. They are used
+// to run the game on machines without GPU, including non-Windows ones.
+//
+#if !defined(CORE_HEADLESS)
 #include <d3d11.h>
+#include <d3d11_1.h>
+#endif
 #include <DirectXMath.h>
+#if defined(_WIN32)
 #include <Windows.h>
+#endif
+#if !defined(CORE_HEADLESS)
 #include <wrl/client.h>
+#endif
+
+#if !defined(_MSC_VER)
+#define __forceinline inline __attribute__((__always_inline__))
+#endif
 
 //
 // Implements bit ops for specified enum class.
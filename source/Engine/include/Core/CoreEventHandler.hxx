@@ -9,11 +9,15 @@
 
 #include <Core/Common.hxx>
 #include <Core/Reference.hxx>
+#if !defined(CORE_HEADLESS)
 #include <Core/CoreWindow.hxx>
+#endif
 #include <Core/Common.hxx>
 
 namespace Core
 {
+    class CoreWindow;
+
     enum class MouseButton
     {
         Left,
@@ -0,0 +1,142 @@
+#ifndef INCLUDED_CORE_JOBS_HXX
+#define INCLUDED_CORE_JOBS_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+#include <algorithm>
+#include <atomic>
+
+namespace Core
+{
+    struct Job;
+    using JobFunction = void(*)(Job* job, const void* data);
+
+    //
+    // Single unit of work.
+    //
+    // Jobs are allocated from per worker ring buffers and never freed explicitly. Job data is
+    // copied to small inline payload, so scheduling doesn't touch heap.
+    //
+    struct alignas(64) Job final
+    {
+        static constexpr const size_t MaxContinuations = 4;
+
+        JobFunction Function;
+        Job* Parent;
+        std::atomic<int32_t> UnfinishedJobs;
+        std::atomic<int32_t> ContinuationCount;
+        Job* Continuations[MaxContinuations];
+        uint8_t Payload[128
+            - sizeof(JobFunction)
+            - sizeof(Job*)
+            - sizeof(std::atomic<int32_t>) * 2
+            - sizeof(Job*) * MaxContinuations];
+    };
+    static_assert(sizeof(Job) == 128, "Job must fit in two cache lines");
+
+    //
+    // Work stealing job scheduler.
+    //
+    // Each worker owns a double ended queue. Owner pushes and pops jobs at the bottom, idle workers
+    // steal from the top of other queues. Main thread is worker 0 and participates in work while
+    // waiting for jobs.
+    //
+    class Jobs final
+    {
+    public:
+        Jobs() = delete;
+        Jobs(const Jobs&) = delete;
+        Jobs& operator = (const Jobs&) = delete;
+
+    public:
+        //
+        // Starts worker threads. Zero worker count means one worker per hardware thread.
+        //
+        static void Initialize(uint32_t workerCount = 0) noexcept;
+        static void Shutdown() noexcept;
+
+    public:
+        //
+        // Total number of workers, including main thread.
+        //
+        static uint32_t GetWorkerCount() noexcept;
+
+        //
+        // Index of worker executing current thread, in range [0, GetWorkerCount()).
+        //
+        static uint32_t GetCurrentWorkerIndex() noexcept;
+
+    public:
+        //
+        // Creates job. When parent is given, parent is not finished until all its children are.
+        //
+        static Job* Create(JobFunction function, Job* parent = nullptr) noexcept;
+        static Job* Create(JobFunction function, const void* data, size_t size, Job* parent = nullptr) noexcept;
+
+        //
+        // Schedules continuation to be run when job is finished. Must be called before job is run.
+        //
+        static void AddContinuation(Job* job, Job* continuation) noexcept;
+
+        static void Run(Job* job) noexcept;
+
+        //
+        // Waits for job, executing other jobs meanwhile.
+        //
+        static void Wait(const Job* job) noexcept;
+
+        static bool IsFinished(const Job* job) noexcept
+        {
+            return job->UnfinishedJobs.load(std::memory_order_acquire) <= 0;
+        }
+
+    public:
+        using ParallelForFunction = void(*)(void* context, size_t begin, size_t end);
+
+        //
+        // Splits range into chunks of `grain` elements and processes them in parallel.
+        // Blocks until whole range is processed.
+        //
+        // Large ranges are split into chunks of several grains, so single call never schedules more
+        // jobs than calling worker can hold. Chunk boundaries are always multiples of grain.
+        //
+        static void ParallelFor(size_t count, size_t grain, ParallelForFunction function, void* context) noexcept;
+
+        template <typename TFunction>
+        static void ParallelFor(size_t count, size_t grain, TFunction&& function) noexcept
+        {
+            using TCallable = typename std::remove_reference<TFunction>::type;
+
+            Jobs::ParallelFor(count, grain, [](void* context, size_t begin, size_t end)
+            {
+                (*static_cast<TCallable*>(context))(begin, end);
+            }, const_cast<void*>(static_cast<const void*>(&function)));
+        }
+
+        //
+        // Calls function(chunk, begin, end) for each grain sized chunk of range, in parallel. Chunk
+        // index lets caller keep per chunk output without synchronization.
+        //
+        template <typename TFunction>
+        static void ParallelChunks(size_t count, size_t grain, TFunction&& function) noexcept
+        {
+            Jobs::ParallelFor(count, grain, [&](size_t begin, size_t end)
+            {
+                //
+                // Range spans multiple chunks when it's run inline or coarsened by ParallelFor.
+                //
+                for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grain)
+                {
+                    function(chunkBegin / grain, chunkBegin, (std::min)(chunkBegin + grain, end));
+                }
+            });
+        }
+    };
+}
+
+#endif // INCLUDED_CORE_JOBS_HXX
\ No newline at end of file
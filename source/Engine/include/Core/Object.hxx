@@ -34,12 +34,20 @@ namespace Core
 
         static __forceinline Type Increment(Type& value) noexcept
         {
+#if defined(_WIN32)
             return ::InterlockedIncrement(reinterpret_cast<::LONG volatile*>(&value));
+#else
+            return __atomic_add_fetch(&value, 1, __ATOMIC_ACQ_REL);
+#endif
         }
 
         static __forceinline Type Decrement(Type& value) noexcept
         {
+#if defined(_WIN32)
             return ::InterlockedDecrement(reinterpret_cast<::LONG volatile*>(&value));
+#else
+            return __atomic_sub_fetch(&value, 1, __ATOMIC_ACQ_REL);
+#endif
         }
     };
 }
@@ -0,0 +1,106 @@
+#ifndef INCLUDED_CORE_RANDOM_HXX
+#define INCLUDED_CORE_RANDOM_HXX
+
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Common.hxx>
+
+namespace Core
+{
+    //
+    // Four independent xoshiro128+ generators running in lockstep, one per vector lane.
+    //
+    // State is kept as structure of arrays, so each step is a handful of 128-bit integer operations
+    // which compiler vectorizes. Floats are made by placing top 23 bits of output into mantissa of
+    // number in [1, 2), so conversion is exact and doesn't depend on rounding mode.
+    //
+    class RandomGenerator final
+    {
+    private:
+        alignas(16) uint32_t m_State[4][4];
+
+    public:
+        explicit RandomGenerator(uint64_t seed = 0) noexcept
+        {
+            Seed(seed);
+        }
+
+    public:
+        //
+        // Expands seed to all lanes with splitmix64, as recommended by xoshiro authors.
+        //
+        void Seed(uint64_t seed) noexcept
+        {
+            for (auto& word : m_State)
+            {
+                for (size_t lane = 0; lane < 4; lane += 2)
+                {
+                    seed += UINT64_C(0x9E3779B97F4A7C15);
+
+                    auto value = seed;
+                    value = (value ^ (value >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+                    value = (value ^ (value >> 27)) * UINT64_C(0x94D049BB133111EB);
+                    value = value ^ (value >> 31);
+
+                    word[lane + 0] = static_cast<uint32_t>(value);
+                    word[lane + 1] = static_cast<uint32_t>(value >> 32);
+                }
+            }
+        }
+
+        //
+        // Advances all lanes by single step.
+        //
+        void Next(uint32_t (&result)[4]) noexcept
+        {
+            auto& s0 = m_State[0];
+            auto& s1 = m_State[1];
+            auto& s2 = m_State[2];
+            auto& s3 = m_State[3];
+
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                result[lane] = s0[lane] + s3[lane];
+
+                const auto t = s1[lane] << 9;
+
+                s2[lane] ^= s0[lane];
+                s3[lane] ^= s1[lane];
+                s1[lane] ^= s2[lane];
+                s0[lane] ^= s3[lane];
+                s2[lane] ^= t;
+                s3[lane] = (s3[lane] << 11) | (s3[lane] >> 21);
+            }
+        }
+
+        //
+        // Uniformly distributed values in [0, 1).
+        //
+        DirectX::XMVECTOR XM_CALLCONV NextVector() noexcept
+        {
+            alignas(16) uint32_t bits[4];
+            Next(bits);
+
+            for (auto& value : bits)
+            {
+                value = (value >> 9) | UINT32_C(0x3F800000);
+            }
+
+            return DirectX::XMVectorSubtract(DirectX::XMLoadInt4A(bits), DirectX::XMVectorSplatOne());
+        }
+
+        //
+        // Uniformly distributed values in [min, max).
+        //
+        DirectX::XMVECTOR XM_CALLCONV NextVector(DirectX::FXMVECTOR min, DirectX::FXMVECTOR max) noexcept
+        {
+            return DirectX::XMVectorMultiplyAdd(NextVector(), DirectX::XMVectorSubtract(max, min), min);
+        }
+    };
+}
+
+#endif // INCLUDED_CORE_RANDOM_HXX
\ No newline at end of file
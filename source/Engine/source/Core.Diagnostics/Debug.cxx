@@ -8,17 +8,23 @@
 #include <Core.Diagnostics/Trace.hxx>
 #include <Core/StringFormat.hxx>
 #include <Core/Environment.hxx>
-#include <Windows.h>
 #include <codecvt>
 #include <sstream>
 
+#if defined(_WIN32)
+#include <Windows.h>
 #include <DbgHelp.h>
 #include <crtdbg.h>
 
 #pragma comment(lib, "Dbghelp.lib")
+#else
+#include <cstdio>
+#include <cstdlib>
+#endif
 
 namespace Core::Diagnostics
 {
+#if defined(_WIN32)
     //
     // Whoosh, a lot of things :)
     //
@@ -204,6 +210,7 @@ namespace Core::Diagnostics
             return TRUE;
         }
     }
+#endif
 
     void Debug::Initialize() noexcept
     {
@@ -223,6 +230,7 @@ namespace Core::Diagnostics
         //
         _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
+#if defined(_WIN32)
         //
         // Register unhandled exception filter.
         //
@@ -249,6 +257,7 @@ namespace Core::Diagnostics
         debug_purecall_handler = _set_purecall_handler(error_handling_purecall_handler);
 
         ::SetConsoleCtrlHandler(error_handling_handler_routine_handler, TRUE);
+#endif
     }
 
     void Debug::Shutdown() noexcept
@@ -257,8 +266,13 @@ namespace Core::Diagnostics
 
     void Debug::WriteLine(const char* line) noexcept
     {
+#if defined(_WIN32)
         ::OutputDebugStringA(line);
         ::OutputDebugStringA("\n");
+#else
+        std::fputs(line, stderr);
+        std::fputc('\n', stderr);
+#endif
     }
 
     void Debug::Fail(const char* message) noexcept
@@ -268,6 +282,7 @@ namespace Core::Diagnostics
         //
         Trace::WriteLine("%s", message);
 
+#if defined(_WIN32)
         //
         // Convert message to 
         //
@@ -294,6 +309,15 @@ namespace Core::Diagnostics
         // And terminate process.
         //
         ::TerminateProcess(::GetCurrentProcess(), EXIT_FAILURE);
+#else
+        //
+        // Nobody to show message box to.
+        //
+        Debug::Shutdown();
+        Trace::Shutdown();
+
+        std::_Exit(EXIT_FAILURE);
+#endif
     }
 
     bool Debug::AssertionFailed(const char* message, const char* function, const char* file, unsigned int line) noexcept
@@ -317,6 +341,7 @@ namespace Core::Diagnostics
         auto text = ss.str();
         Trace::WriteLine("%s", text.c_str());
 
+#if defined(_WIN32)
         //
         // And show message box.
         //
@@ -339,6 +364,7 @@ namespace Core::Diagnostics
                 return false;
             }
         }
+#endif
 
         //
         // Default failsafe.
@@ -64,7 +64,11 @@ namespace Core::Diagnostics
             auto t = std::time(nullptr);
             std::tm time{};
 
+#if defined(_MSC_VER)
             localtime_s(&time, &t);
+#else
+            localtime_r(&t, &time);
+#endif
 
             TraceOutputLog << std::put_time(&time, "[%d-%m-%Y %H-%M-%S] ");
         }
@@ -5,19 +5,301 @@
 //
 
 #include <Core.Rendering/CommandList.hxx>
+#include <Core.Rendering/RenderSystem.hxx>
 
 namespace Core::Rendering
 {
+    namespace
+    {
+        //
+        // Updates shadowed value and tells whether call has to be forwarded to context.
+        //
+        template <typename T>
+        bool UpdateBinding(T& bound, T value, CommandListCounter& counter) noexcept
+        {
+            if (bound == value)
+            {
+                ++counter.Filtered;
+                return false;
+            }
+
+            bound = value;
+            ++counter.Issued;
+            return true;
+        }
+    }
+
     CommandList::CommandList(RenderSystem* renderSystem, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context) noexcept
         : m_RenderSystem{ renderSystem }
         , m_Context{ context }
+        , m_Bound{}
+        , m_Statistics{}
+        , m_Recorded{}
+        , m_IsDeferred{ context->GetType() == D3D11_DEVICE_CONTEXT_DEFERRED }
+        , m_Context1{}
+        , m_UniformPages{}
+        , m_UniformStaging{}
+        , m_FallbackUniforms{}
+        , m_FallbackSlices{}
+        , m_FallbackDirty{ 0 }
+        , m_UniformRingData{ nullptr }
+        , m_UniformPage{ 0 }
+        , m_UniformRingOffset{ 0 }
+        , m_UniformRingDiscard{ true }
     {
+        InvalidateState();
+
+        auto device = m_RenderSystem->m_Device;
+
+        //
+        // Binding constant buffer ranges needs D3D11.1 runtime and driver support. Only deferred
+        // contexts need driver to allow mapping ring without discard; immediate context always
+        // supports it with offsetting.
+        //
+        D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+
+        if (SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)))
+            && options.ConstantBufferOffsetting
+            && (!m_IsDeferred || options.MapNoOverwriteOnDynamicConstantBuffer))
+        {
+            (void)m_Context.As(&m_Context1);
+        }
+
+        if (m_Context1.Get() == nullptr)
+        {
+            CORE_TRACE_MESSAGE(Info, "[D3D11] Constant buffer offsetting not supported, uniforms are uploaded per slot before draw");
+        }
+
+        AddUniformPage();
     }
 
     CommandList::~CommandList() noexcept
     {
     }
 
+    void CommandList::InvalidateState() noexcept
+    {
+        m_Bound = BoundState{};
+        m_Bound.PrimitiveTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+        m_Bound.IndexFormat = DXGI_FORMAT_UNKNOWN;
+    }
+
+    void CommandList::ResetStatistics() noexcept
+    {
+        m_Statistics = CommandListStatistics{};
+    }
+
+    void CommandList::ResetUniformRing() noexcept
+    {
+        FlushUniforms();
+
+        //
+        // Next map discards first page; driver renames it, so slices of frames still in flight
+        // stay intact.
+        //
+        m_UniformPage = 0;
+        m_UniformRingOffset = 0;
+        m_UniformRingDiscard = true;
+
+        //
+        // Staged slices are reused by next frame, so uploaded content can't be matched anymore.
+        //
+        for (auto& slice : m_FallbackSlices)
+        {
+            slice = UniformAllocation{};
+        }
+    }
+
+    void CommandList::AddUniformPage() noexcept
+    {
+        if (m_Context1.Get() != nullptr)
+        {
+            D3D11_BUFFER_DESC sd{};
+            sd.Usage = D3D11_USAGE_DYNAMIC;
+            sd.ByteWidth = UniformRingSize;
+            sd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+            sd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            sd.MiscFlags = 0;
+
+            Microsoft::WRL::ComPtr<ID3D11Buffer> page{};
+            DX::Ensure(m_RenderSystem->m_Device->CreateBuffer(&sd, nullptr, page.GetAddressOf()));
+
+            m_UniformPages.push_back(page);
+        }
+        else
+        {
+            m_UniformStaging.emplace_back(UniformRingSize);
+        }
+    }
+
+    void CommandList::Finish() noexcept
+    {
+        CORE_ASSERT(m_IsDeferred);
+        CORE_ASSERT(m_Recorded.Get() == nullptr);
+
+        //
+        // Ring must be unmapped before list is closed; first map of next batch discards it, as
+        // required on deferred contexts.
+        //
+        ResetUniformRing();
+
+        DX::Ensure(m_Context->FinishCommandList(FALSE, m_Recorded.GetAddressOf()));
+
+        InvalidateState();
+    }
+
+    void CommandList::BindViewport(const ViewportRef& viewport) noexcept
+    {
+        ::D3D11_VIEWPORT desc{};
+        desc.TopLeftX = 0.0F;
+        desc.TopLeftY = 0.0F;
+        desc.Width = static_cast<float>(viewport->m_Width);
+        desc.Height = static_cast<float>(viewport->m_Height);
+        desc.MinDepth = 0.0F;
+        desc.MaxDepth = 1.0F;
+
+        m_Context->RSSetViewports(1, &desc);
+
+        m_Context->OMSetRenderTargets(
+            1,
+            viewport->m_RenderTargetView.GetAddressOf(),
+            viewport->m_DepthStencilView.Get()
+        );
+    }
+
+    UniformAllocation CommandList::AllocateUniforms(size_t size) noexcept
+    {
+        const auto aligned = static_cast<uint32_t>((size + (UniformAlignment - 1)) & ~static_cast<size_t>(UniformAlignment - 1));
+
+        CORE_ASSERT(aligned != 0 && aligned <= MaxUniformSize);
+
+        if (m_UniformRingOffset + aligned > UniformRingSize)
+        {
+            //
+            // Page is full; continue on next one, which is discarded on its first map.
+            //
+            FlushUniforms();
+
+            ++m_UniformPage;
+            m_UniformRingOffset = 0;
+            m_UniformRingDiscard = true;
+
+            if (m_UniformPage == (std::max)(m_UniformPages.size(), m_UniformStaging.size()))
+            {
+                AddUniformPage();
+            }
+        }
+
+        uint8_t* base = nullptr;
+
+        if (m_Context1.Get() != nullptr)
+        {
+            if (m_UniformRingData == nullptr)
+            {
+                //
+                // Slices written since last draw share single map.
+                //
+                D3D11_MAPPED_SUBRESOURCE subresource{};
+                DX::Ensure(m_Context->Map(m_UniformPages[m_UniformPage].Get(), 0, m_UniformRingDiscard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &subresource));
+
+                m_UniformRingData = static_cast<uint8_t*>(subresource.pData);
+                m_UniformRingDiscard = false;
+                ++m_Statistics.UniformUploads;
+            }
+
+            base = m_UniformRingData;
+        }
+        else
+        {
+            base = m_UniformStaging[m_UniformPage].data();
+        }
+
+        UniformAllocation allocation{ base + m_UniformRingOffset, m_UniformPage, m_UniformRingOffset, aligned };
+        m_UniformRingOffset += aligned;
+        return allocation;
+    }
+
+    void CommandList::BindUniforms(ShaderMask mask, uint32_t index, const UniformAllocation& allocation) noexcept
+    {
+        CORE_ASSERT(index < MaxUniformBuffers);
+
+        if (m_Context1.Get() != nullptr)
+        {
+            SetUniformBinding(mask, index, BoundUniformBuffer{ m_UniformPages[allocation.Page].Get(), allocation.Offset / 16, allocation.Size / 16 });
+            return;
+        }
+
+        //
+        // Fallback: slice is uploaded to buffer dedicated to this slot right before next draw.
+        // Rebinding slot between draws only replaces pending slice, and slice which is already
+        // uploaded to it is not uploaded again.
+        //
+        auto& slice = m_FallbackSlices[index];
+
+        if (slice.Data != allocation.Data || slice.Size != allocation.Size)
+        {
+            slice = allocation;
+            m_FallbackDirty |= (1U << index);
+        }
+
+        auto& buffer = m_FallbackUniforms[index];
+
+        if (buffer.Get() == nullptr)
+        {
+            D3D11_BUFFER_DESC sd{};
+            sd.Usage = D3D11_USAGE_DYNAMIC;
+            sd.ByteWidth = MaxUniformSize;
+            sd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+            sd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            sd.MiscFlags = 0;
+
+            DX::Ensure(m_RenderSystem->m_Device->CreateBuffer(&sd, nullptr, buffer.GetAddressOf()));
+        }
+
+        SetUniformBinding(mask, index, BoundUniformBuffer{ buffer.Get(), 0, 0 });
+    }
+
+    void CommandList::SetUniforms(ShaderMask mask, uint32_t index, const void* data, size_t size) noexcept
+    {
+        const auto allocation = AllocateUniforms(size);
+        std::memcpy(allocation.Data, data, size);
+        BindUniforms(mask, index, allocation);
+    }
+
+    void CommandList::FlushUniforms() noexcept
+    {
+        //
+        // Buffer must be unmapped before draw reads it.
+        //
+        if (m_UniformRingData != nullptr)
+        {
+            m_Context->Unmap(m_UniformPages[m_UniformPage].Get(), 0);
+            m_UniformRingData = nullptr;
+        }
+
+        //
+        // Upload pending fallback slices, once per slot.
+        //
+        for (uint32_t index = 0; m_FallbackDirty != 0; ++index)
+        {
+            const auto bit = (1U << index);
+
+            if ((m_FallbackDirty & bit) != 0)
+            {
+                const auto& slice = m_FallbackSlices[index];
+                auto buffer = m_FallbackUniforms[index].Get();
+
+                D3D11_MAPPED_SUBRESOURCE subresource{};
+                DX::Ensure(m_Context->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &subresource));
+                std::memcpy(subresource.pData, slice.Data, slice.Size);
+                m_Context->Unmap(buffer, 0);
+                ++m_Statistics.UniformUploads;
+
+                m_FallbackDirty &= ~bit;
+            }
+        }
+    }
+
     void CommandList::BeginOcclusionQuery(const OcclusionQueryRef& query) noexcept
     {
         m_Context->Begin(query->m_Query.Get());
@@ -42,36 +324,103 @@ namespace Core::Rendering
 
     void CommandList::BindGraphicsPipelineState(const GraphicsPipelineStateRef& state) noexcept
     {
-        FLOAT blend[4] = { 1.0F, 1.0F, 1.0F, 1.0F };
+        //
+        // Device returns the same state objects for equal descriptions, so different pipeline
+        // states often share some of them. Each part is filtered separately.
+        //
+        bool changed = false;
+
+        if (m_Bound.BlendState != state->m_BlendState.Get())
+        {
+            FLOAT blend[4] = { 1.0F, 1.0F, 1.0F, 1.0F };
+
+            m_Bound.BlendState = state->m_BlendState.Get();
+            m_Context->OMSetBlendState(m_Bound.BlendState, blend, 0xff);
+            changed = true;
+        }
+
+        if (m_Bound.DepthStencilState != state->m_DepthStencilState.Get())
+        {
+            m_Bound.DepthStencilState = state->m_DepthStencilState.Get();
+            m_Context->OMSetDepthStencilState(m_Bound.DepthStencilState, 0xff);
+            changed = true;
+        }
+
+        if (m_Bound.RasterizerState != state->m_RasterizerState.Get())
+        {
+            m_Bound.RasterizerState = state->m_RasterizerState.Get();
+            m_Context->RSSetState(m_Bound.RasterizerState);
+            changed = true;
+        }
+
+        if (m_Bound.InputLayout != state->m_InputLayout.Get())
+        {
+            m_Bound.InputLayout = state->m_InputLayout.Get();
+            m_Context->IASetInputLayout(m_Bound.InputLayout);
+            changed = true;
+        }
+
+        if (m_Bound.PrimitiveTopology != state->m_PrimitiveTopology)
+        {
+            m_Bound.PrimitiveTopology = state->m_PrimitiveTopology;
+            m_Context->IASetPrimitiveTopology(m_Bound.PrimitiveTopology);
+            changed = true;
+        }
 
-        m_Context->OMSetBlendState(state->m_BlendState.Get(), blend, 0xff);
-        m_Context->OMSetDepthStencilState(state->m_DepthStencilState.Get(), 0xff);
-        m_Context->RSSetState(state->m_RasterizerState.Get());
-        m_Context->IASetInputLayout(state->m_InputLayout.Get());
-        m_Context->IASetPrimitiveTopology(state->m_PrimitiveTopology);
+        if (m_Bound.PixelShader != state->m_PixelShader.Get())
+        {
+            m_Bound.PixelShader = state->m_PixelShader.Get();
+            m_Context->PSSetShader(m_Bound.PixelShader, nullptr, 0);
+            changed = true;
+        }
+
+        if (m_Bound.VertexShader != state->m_VertexShader.Get())
+        {
+            m_Bound.VertexShader = state->m_VertexShader.Get();
+            m_Context->VSSetShader(m_Bound.VertexShader, nullptr, 0);
+            changed = true;
+        }
 
-        m_Context->PSSetShader(state->m_PixelShader.Get(), nullptr, 0);
-        m_Context->VSSetShader(state->m_VertexShader.Get(), nullptr, 0);
+        ++(changed ? m_Statistics.PipelineStates.Issued : m_Statistics.PipelineStates.Filtered);
     }
 
     void CommandList::BindUniformBuffer(ShaderMask mask, uint32_t index, const UniformBufferRef& buffer) noexcept
     {
-        auto native = buffer->m_Buffer.GetAddressOf();
+        CORE_ASSERT(index < MaxUniformBuffers);
+
+        SetUniformBinding(mask, index, BoundUniformBuffer{ buffer->m_Buffer.Get(), 0, 0 });
+    }
 
+    void CommandList::SetUniformBinding(ShaderMask mask, uint32_t index, const BoundUniformBuffer& binding) noexcept
+    {
         //
         // Try to set buffer in Pixel Shader.
         //
-        if (!!(mask & ShaderMask::Pixel))
+        if (!!(mask & ShaderMask::Pixel) && UpdateBinding(m_Bound.PixelUniformBuffers[index], binding, m_Statistics.UniformBuffers))
         {
-            m_Context->PSSetConstantBuffers(index, 1, native);
+            if (binding.ConstantCount != 0)
+            {
+                m_Context1->PSSetConstantBuffers1(index, 1, &binding.Buffer, &binding.FirstConstant, &binding.ConstantCount);
+            }
+            else
+            {
+                m_Context->PSSetConstantBuffers(index, 1, &binding.Buffer);
+            }
         }
 
         //
         // Try to set buffer in Vertex Shader.
         //
-        if (!!(mask & ShaderMask::Vertex))
+        if (!!(mask & ShaderMask::Vertex) && UpdateBinding(m_Bound.VertexUniformBuffers[index], binding, m_Statistics.UniformBuffers))
         {
-            m_Context->VSSetConstantBuffers(index, 1, native);
+            if (binding.ConstantCount != 0)
+            {
+                m_Context1->VSSetConstantBuffers1(index, 1, &binding.Buffer, &binding.FirstConstant, &binding.ConstantCount);
+            }
+            else
+            {
+                m_Context->VSSetConstantBuffers(index, 1, &binding.Buffer);
+            }
         }
 
         // TODO: Support other shader types.
@@ -84,21 +433,47 @@ namespace Core::Rendering
         auto nativeStride = static_cast<::UINT>(stride);
         auto nativeOffset = static_cast<::UINT>(offset);
 
+        CORE_ASSERT(index < MaxVertexBuffers);
+
+        auto& bound = m_Bound.VertexBuffers[index];
+
+        if (bound.Buffer == *native && bound.Stride == nativeStride && bound.Offset == nativeOffset)
+        {
+            ++m_Statistics.VertexBuffers.Filtered;
+            return;
+        }
+
+        bound = BoundVertexBuffer{ *native, nativeStride, nativeOffset };
+        ++m_Statistics.VertexBuffers.Issued;
+
         m_Context->IASetVertexBuffers(index, 1, native, &nativeStride, &nativeOffset);
     }
 
     void CommandList::BindIndexBuffer(const IndexBufferRef& buffer, bool isNarrow) noexcept
     {
         auto native = buffer->m_Buffer.Get();
+        auto format = isNarrow ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 
-        m_Context->IASetIndexBuffer(native, isNarrow ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
+        if (m_Bound.IndexBuffer == native && m_Bound.IndexFormat == format)
+        {
+            ++m_Statistics.IndexBuffers.Filtered;
+            return;
+        }
+
+        m_Bound.IndexBuffer = native;
+        m_Bound.IndexFormat = format;
+        ++m_Statistics.IndexBuffers.Issued;
+
+        m_Context->IASetIndexBuffer(native, format, 0);
     }
 
     void CommandList::BindSampler(ShaderMask mask, uint32_t index, const SamplerRef& sampler) noexcept
     {
+        CORE_ASSERT(index < MaxSamplers);
+
         auto native = sampler->m_Sampler.GetAddressOf();
 
-        if (!!(mask & ShaderMask::Pixel))
+        if (!!(mask & ShaderMask::Pixel) && UpdateBinding(m_Bound.PixelSamplers[index], *native, m_Statistics.Samplers))
         {
             m_Context->PSSetSamplers(index, 1, native);
         }
@@ -108,9 +483,11 @@ namespace Core::Rendering
 
     void CommandList::BindTexture2D(ShaderMask mask, uint32_t index, const Texture2DRef& texture) noexcept
     {
+        CORE_ASSERT(index < MaxTextures);
+
         auto native = texture->m_ShaderResourceView.GetAddressOf();
 
-        if (!!(mask & ShaderMask::Pixel))
+        if (!!(mask & ShaderMask::Pixel) && UpdateBinding(m_Bound.PixelTextures[index], *native, m_Statistics.Textures))
         {
             m_Context->PSSetShaderResources(index, 1, native);
         }
@@ -120,21 +497,29 @@ namespace Core::Rendering
 
     void CommandList::DrawIndexed(uint32_t indexCount, uint32_t startLocation, uint32_t baseVertexLocation) noexcept
     {
+        FlushUniforms();
+        ++m_Statistics.DrawCalls;
         m_Context->DrawIndexed(indexCount, startLocation, baseVertexLocation);
     }
 
     void CommandList::DrawIndexedInstanced(uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation, uint32_t baseVertexLocation, uint32_t startInstanceLocation) noexcept
     {
+        FlushUniforms();
+        ++m_Statistics.DrawCalls;
         m_Context->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
     }
 
     void CommandList::Draw(uint32_t vertexCount, uint32_t startVertexLocation) noexcept
     {
+        FlushUniforms();
+        ++m_Statistics.DrawCalls;
         m_Context->Draw(vertexCount, startVertexLocation);
     }
 
     void CommandList::DrawInstanced(uint32_t vertexCountPerInstance, uint32_t instanceCount, uint32_t startVertexLocation, uint32_t startInstanceLocation) noexcept
     {
+        FlushUniforms();
+        ++m_Statistics.DrawCalls;
         m_Context->DrawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
     }
 
@@ -150,6 +535,7 @@ namespace Core::Rendering
         //
         D3D11_MAPPED_SUBRESOURCE subresource{};
         DX::Ensure(m_Context->Map(native, 0, D3D11_MAP_WRITE_DISCARD, 0, &subresource));
+        ++m_Statistics.UniformUploads;
 
         //
         // ...copy...
@@ -161,4 +547,19 @@ namespace Core::Rendering
         //
         m_Context->Unmap(native, 0);
     }
+
+    void CommandList::UpdateVertexBuffer(const VertexBufferRef& buffer, const void* data, size_t size) noexcept
+    {
+        auto native = buffer->m_Buffer.Get();
+
+        //
+        // Buffer is renamed by driver on discard, so draws still using old content are not stalled.
+        //
+        D3D11_MAPPED_SUBRESOURCE subresource{};
+        DX::Ensure(m_Context->Map(native, 0, D3D11_MAP_WRITE_DISCARD, 0, &subresource));
+
+        std::memcpy(subresource.pData, data, size);
+
+        m_Context->Unmap(native, 0);
+    }
 }
\ No newline at end of file
@@ -11,7 +11,7 @@
 namespace Core::Rendering
 {
 
-    MaterialRenderer::MaterialRenderer(const std::string& pixelShader, const std::string& vertexShader) noexcept
+    MaterialRenderer::MaterialRenderer(const std::string& pixelShader, const std::string& vertexShader, const std::string& instancedVertexShader) noexcept
     {
         //
         // Setup color.
@@ -23,19 +23,6 @@ namespace Core::Rendering
         //
         auto renderSystem = Core::Rendering::RenderSystem::Current;
 
-        //
-        // Setup material data uniform buffer.
-        //
-        {
-            Core::Rendering::BufferDesc buffer
-            {
-                &m_ShaderParams,
-                sizeof(m_ShaderParams)
-            };
-
-            m_ShaderParamsBuffer = renderSystem->MakeUniformBuffer(buffer);
-        }
-
         //
         // Create pipeline state object. Somewhat Vulkan`ish or D3D12`ish :)
         //
@@ -104,6 +91,31 @@ namespace Core::Rendering
         // Make it run!
         //
         m_PipelineState = renderSystem->MakeGraphicsPipelineState(gd);
+
+        if (!instancedVertexShader.empty())
+        {
+            //
+            // Instanced variant shares everything but vertex shader and input layout. World matrix
+            // rows are streamed per instance from slot 1.
+            //
+            D3D11_INPUT_ELEMENT_DESC instancedInput[]
+            {
+                { "SV_Position", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+                { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+                { "TEXCOORD", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+                { "WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+                { "WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+                { "WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+                { "WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            };
+
+            gd.InputLayout = instancedInput;
+            gd.InputLayoutCount = sizeof(instancedInput) / sizeof(instancedInput[0]);
+
+            Core::FileSystem::Load(gd.VertexShader.Code, instancedVertexShader);
+
+            m_InstancedPipelineState = renderSystem->MakeGraphicsPipelineState(gd);
+        }
     }
 
     MaterialRenderer::~MaterialRenderer() noexcept
@@ -112,20 +124,26 @@ namespace Core::Rendering
 
     void MaterialRenderer::Bind(const Core::Rendering::CommandListRef& commandList) noexcept
     {
-        //
-        // Update buffer content.
-        //
-        commandList->UpdateUniformBuffer(m_ShaderParamsBuffer, &m_ShaderParams, sizeof(m_ShaderParams));
+        Bind(commandList, m_PipelineState);
+    }
 
+    void MaterialRenderer::BindInstanced(const Core::Rendering::CommandListRef& commandList) noexcept
+    {
+        CORE_ASSERT(IsInstanced());
+        Bind(commandList, m_InstancedPipelineState);
+    }
+
+    void MaterialRenderer::Bind(const Core::Rendering::CommandListRef& commandList, const GraphicsPipelineStateRef& pipelineState) noexcept
+    {
         //
-        // Bind buffer to pixel shader.
+        // Upload material data to uniform ring and bind it to pixel shader.
         //
-        commandList->BindUniformBuffer(Core::Rendering::ShaderMask::Pixel, 0, m_ShaderParamsBuffer);
+        commandList->SetUniforms(Core::Rendering::ShaderMask::Pixel, 0, &m_ShaderParams, sizeof(m_ShaderParams));
 
         //
         // Bind pipeline state.
         //
-        commandList->BindGraphicsPipelineState(m_PipelineState);
+        commandList->BindGraphicsPipelineState(pipelineState);
 
         //
         // Bind sampler.
@@ -155,10 +155,6 @@ namespace Core::Rendering
         //
         commandList->BindVertexBuffer(0, m_VertexBuffer, sizeof(Vertex), 0);
         commandList->BindIndexBuffer(m_IndexBuffer, true);
-
-        //
-        // This approach is fast, but instancing would be faster.
-        //
     }
 
     void MeshRenderer::Render(const Rendering::CommandListRef& commandList) noexcept
@@ -168,4 +164,9 @@ namespace Core::Rendering
         //
         commandList->DrawIndexed(3 * 2 * 6, 0, 0);
     }
+
+    void MeshRenderer::RenderInstanced(const Rendering::CommandListRef& commandList, uint32_t instanceCount, uint32_t startInstance) noexcept
+    {
+        commandList->DrawIndexedInstanced(3 * 2 * 6, instanceCount, 0, 0, startInstance);
+    }
 }
\ No newline at end of file
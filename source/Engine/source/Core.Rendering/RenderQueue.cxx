@@ -0,0 +1,81 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core.Rendering/RenderQueue.hxx>
+
+namespace Core::Rendering
+{
+    namespace
+    {
+        constexpr const uint32_t DigitBits = 8;
+        constexpr const uint32_t DigitCount = 64 / DigitBits;
+        constexpr const uint32_t BucketCount = 1U << DigitBits;
+    }
+
+    RenderQueue::RenderQueue() noexcept
+        : m_Items{}
+        , m_Scratch{}
+    {
+    }
+
+    void RenderQueue::Sort() noexcept
+    {
+        const auto count = m_Items.size();
+
+        if (count < 2)
+        {
+            return;
+        }
+
+        //
+        // Histograms of all digits at once.
+        //
+        uint32_t histograms[DigitCount][BucketCount]{};
+
+        for (const auto& item : m_Items)
+        {
+            for (uint32_t digit = 0; digit < DigitCount; ++digit)
+            {
+                ++histograms[digit][(item.Key >> (digit * DigitBits)) & (BucketCount - 1)];
+            }
+        }
+
+        m_Scratch.resize(count);
+
+        for (uint32_t digit = 0; digit < DigitCount; ++digit)
+        {
+            auto& histogram = histograms[digit];
+            const auto shift = digit * DigitBits;
+
+            //
+            // All keys share this digit, pass wouldn't change order.
+            //
+            if (histogram[(m_Items[0].Key >> shift) & (BucketCount - 1)] == count)
+            {
+                continue;
+            }
+
+            //
+            // Turn counts to offsets and scatter.
+            //
+            uint32_t offset = 0;
+
+            for (auto& bucket : histogram)
+            {
+                const auto size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+
+            for (const auto& item : m_Items)
+            {
+                m_Scratch[histogram[(item.Key >> shift) & (BucketCount - 1)]++] = item;
+            }
+
+            m_Items.swap(m_Scratch);
+        }
+    }
+}
\ No newline at end of file
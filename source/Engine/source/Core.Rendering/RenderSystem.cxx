@@ -58,26 +58,9 @@ namespace Core::Rendering
     void RenderSystem::BeginDrawViewport(const ViewportRef& viewport) noexcept
     {
         //
-        // Setup viewport description.
+        // Bind viewport and its render targets.
         //
-        ::D3D11_VIEWPORT desc{};
-        desc.TopLeftX = 0.0F;
-        desc.TopLeftY = 0.0F;
-        desc.Width = static_cast<float>(viewport->m_Width);
-        desc.Height = static_cast<float>(viewport->m_Height);
-        desc.MinDepth = 0.0F;
-        desc.MaxDepth = 1.0F;
-
-        m_ImmediateContext->RSSetViewports(1, &desc);
-
-        //
-        // Bind viewport render targets.
-        //
-        m_ImmediateContext->OMSetRenderTargets(
-            1,
-            viewport->m_RenderTargetView.GetAddressOf(),
-            viewport->m_DepthStencilView.Get()
-        );
+        m_DefaultImmediateContext->BindViewport(viewport);
 
         FLOAT color[4] = {
             0.0F,
@@ -115,9 +98,9 @@ namespace Core::Rendering
         (void)deltaTime;
     }
 
-    VertexBufferRef RenderSystem::MakeVertexBuffer(const BufferDesc& desc) noexcept
+    VertexBufferRef RenderSystem::MakeVertexBuffer(const BufferDesc& desc, bool isDynamic) noexcept
     {
-        return MakeRef<VertexBuffer>(this, desc);
+        return MakeRef<VertexBuffer>(this, desc, isDynamic);
     }
 
     IndexBufferRef RenderSystem::MakeIndexBuffer(const BufferDesc& desc) noexcept
@@ -148,6 +131,53 @@ namespace Core::Rendering
         return MakeRef<CommandList>(this, context);
     }
 
+    CommandListRef RenderSystem::GetDeferredCommandList(size_t index) noexcept
+    {
+        while (m_DeferredCommandLists.size() <= index)
+        {
+            m_DeferredCommandLists.push_back(MakeCommandList());
+        }
+
+        return m_DeferredCommandLists[index];
+    }
+
+    void RenderSystem::Execute(const CommandListRef& commandList) noexcept
+    {
+        CORE_ASSERT(commandList->m_Recorded.Get() != nullptr);
+
+        //
+        // Don't restore context state; it's cheaper and everything drawn later sets its own.
+        //
+        m_ImmediateContext->ExecuteCommandList(commandList->m_Recorded.Get(), FALSE);
+        commandList->m_Recorded.Reset();
+
+        auto& immediate = m_DefaultImmediateContext;
+        immediate->InvalidateState();
+
+        //
+        // Account work of deferred list to immediate one, so frame statistics cover both.
+        //
+        const auto& recorded = commandList->m_Statistics;
+        auto& total = immediate->m_Statistics;
+
+        const auto accumulate = [](CommandListCounter& lhs, const CommandListCounter& rhs)
+        {
+            lhs.Issued += rhs.Issued;
+            lhs.Filtered += rhs.Filtered;
+        };
+
+        accumulate(total.PipelineStates, recorded.PipelineStates);
+        accumulate(total.UniformBuffers, recorded.UniformBuffers);
+        accumulate(total.VertexBuffers, recorded.VertexBuffers);
+        accumulate(total.IndexBuffers, recorded.IndexBuffers);
+        accumulate(total.Samplers, recorded.Samplers);
+        accumulate(total.Textures, recorded.Textures);
+        total.DrawCalls += recorded.DrawCalls;
+        total.UniformUploads += recorded.UniformUploads;
+
+        commandList->ResetStatistics();
+    }
+
     SamplerRef RenderSystem::MakeSampler(const SamplerDesc& desc) noexcept
     {
         return MakeRef<Sampler>(this, desc);
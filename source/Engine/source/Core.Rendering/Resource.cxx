@@ -5,14 +5,19 @@
 //
 
 #include <Core.Rendering/Resource.hxx>
+#include <atomic>
 
 namespace Core::Rendering
 {
-    //
-    // Nothing to see here. Move along.
-    //
+    namespace
+    {
+        std::atomic<uint32_t> g_NextSortID{ 1 };
+    }
 
-    Resource::Resource() noexcept = default;
+    Resource::Resource() noexcept
+        : m_SortID{ g_NextSortID.fetch_add(1, std::memory_order_relaxed) }
+    {
+    }
 
     Resource::~Resource() noexcept = default;
 }
\ No newline at end of file
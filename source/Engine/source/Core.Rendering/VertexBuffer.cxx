@@ -9,20 +9,20 @@
 
 namespace Core::Rendering
 {
-    VertexBuffer::VertexBuffer(RenderSystem* renderSystem, const BufferDesc& desc) noexcept
+    VertexBuffer::VertexBuffer(RenderSystem* renderSystem, const BufferDesc& desc, bool isDynamic) noexcept
         : m_RenderSystem{ renderSystem }
         , m_Buffer{}
     {
         auto device = this->m_RenderSystem->m_Device;
 
         //
-        // Standard immutable D3D11 buffer.
+        // Standard immutable D3D11 buffer, or dynamic one mapped by CPU.
         //
         D3D11_BUFFER_DESC sd{};
-        sd.Usage = D3D11_USAGE_IMMUTABLE;
+        sd.Usage = isDynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_IMMUTABLE;
         sd.ByteWidth = static_cast<::UINT>(desc.Size);
         sd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        sd.CPUAccessFlags = 0;
+        sd.CPUAccessFlags = isDynamic ? D3D11_CPU_ACCESS_WRITE : 0;
         sd.MiscFlags = 0;
 
         //
@@ -34,7 +34,7 @@ namespace Core::Rendering
         //
         // Create buffer.
         //
-        DX::Ensure(device->CreateBuffer(&sd, &sr, m_Buffer.GetAddressOf()));
+        DX::Ensure(device->CreateBuffer(&sd, desc.Pointer != nullptr ? &sr : nullptr, m_Buffer.GetAddressOf()));
     }
 
     VertexBuffer::~VertexBuffer() noexcept
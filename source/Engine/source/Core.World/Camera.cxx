@@ -10,25 +10,10 @@
 namespace Core::World
 {
     Camera::Camera() noexcept
+        : m_ShaderParams{}
+        , m_NearZ{ 0.0F }
+        , m_FarZ{ 1.0F }
     {
-
-        //
-        // Get render system.
-        //
-        auto renderSystem = Core::Rendering::RenderSystem::Current;
-
-        //
-        // Setup material data uniform buffer.
-        //
-        {
-            Core::Rendering::BufferDesc buffer
-            {
-                &m_ShaderParams,
-                sizeof(m_ShaderParams)
-            };
-
-            m_ShaderParamsBuffer = renderSystem->MakeUniformBuffer(buffer);
-        }
     }
 
     Camera::~Camera() noexcept
@@ -42,6 +27,9 @@ namespace Core::World
         //
         auto projection = DirectX::XMMatrixPerspectiveFovLH(fov, aspectRatio, nearZ, farZ);
         DirectX::XMStoreFloat4x4A(&m_ShaderParams.Projection, projection);
+
+        m_NearZ = nearZ;
+        m_FarZ = farZ;
     }
 
     void XM_CALLCONV Camera::LookAt(DirectX::FXMVECTOR position, DirectX::FXMVECTOR target, DirectX::FXMVECTOR up) noexcept
@@ -53,16 +41,22 @@ namespace Core::World
         DirectX::XMStoreFloat4x4A(&m_ShaderParams.View, view);
     }
 
-    void Camera::Bind(const Rendering::CommandListRef& commandList) noexcept
+    float XM_CALLCONV Camera::GetNormalizedDepth(DirectX::FXMVECTOR position) const noexcept
     {
         //
-        // Update buffer content.
+        // Only z of view space position is needed; that's third column of view matrix.
         //
-        commandList->UpdateUniformBuffer(m_ShaderParamsBuffer, &m_ShaderParams, sizeof(m_ShaderParams));
+        const auto& view = m_ShaderParams.View;
+        const auto z = DirectX::XMVectorGetX(DirectX::XMVector3Dot(position, DirectX::XMVectorSet(view._13, view._23, view._33, 0.0F))) + view._43;
+
+        return Clamp((z - m_NearZ) / (m_FarZ - m_NearZ), 0.0F, 1.0F);
+    }
 
+    void Camera::Bind(const Rendering::CommandListRef& commandList) noexcept
+    {
         //
-        // Bind buffer to pixel shader.
+        // Upload camera data to uniform ring and bind it to vertex shader.
         //
-        commandList->BindUniformBuffer(Core::Rendering::ShaderMask::Vertex, 0, m_ShaderParamsBuffer);
+        commandList->SetUniforms(Core::Rendering::ShaderMask::Vertex, 0, &m_ShaderParams, sizeof(m_ShaderParams));
     }
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core.World/Components.hxx>
+
+namespace Core::World
+{
+    size_t ComponentStorage::Push(GameObject* object, physx::PxRigidDynamic* rigidBody, GameObjectTypeID typeID) noexcept
+    {
+        //
+        // New slot is always appended at the end.
+        //
+        auto index = Objects.size();
+
+        IDs.push_back(InvalidGameObjectID);
+        Objects.push_back(object);
+        RigidBodies.push_back(rigidBody);
+        Types.push_back(typeID);
+        Flags.push_back(ComponentFlags::None);
+        Positions.push_back(DirectX::XMFLOAT4A{ 0.0F, 0.0F, 0.0F, 0.0F });
+        Orientations.push_back(DirectX::XMFLOAT4A{ 0.0F, 0.0F, 0.0F, 1.0F });
+        PreviousPositions.push_back(DirectX::XMFLOAT4A{ 0.0F, 0.0F, 0.0F, 0.0F });
+        PreviousOrientations.push_back(DirectX::XMFLOAT4A{ 0.0F, 0.0F, 0.0F, 1.0F });
+        Scales.push_back(DirectX::XMFLOAT4A{ 1.0F, 1.0F, 1.0F, 0.0F });
+        Velocities.push_back(DirectX::XMFLOAT4A{ 0.0F, 0.0F, 0.0F, 0.0F });
+        AngularVelocities.push_back(DirectX::XMFLOAT4A{ 0.0F, 0.0F, 0.0F, 0.0F });
+        Extents.push_back(DirectX::XMFLOAT4A{ 0.0F, 0.0F, 0.0F, 0.0F });
+        KinematicTargets.push_back(DirectX::XMFLOAT4A{ 0.0F, 0.0F, 0.0F, 0.0F });
+        Layers.push_back(DefaultCollisionLayer);
+        PlaneHeights.push_back(0.0F);
+
+        return index;
+    }
+
+    void ComponentStorage::Move(size_t target, size_t source) noexcept
+    {
+        IDs[target] = IDs[source];
+        Objects[target] = Objects[source];
+        RigidBodies[target] = RigidBodies[source];
+        Types[target] = Types[source];
+        Flags[target] = Flags[source];
+        Positions[target] = Positions[source];
+        Orientations[target] = Orientations[source];
+        PreviousPositions[target] = PreviousPositions[source];
+        PreviousOrientations[target] = PreviousOrientations[source];
+        Scales[target] = Scales[source];
+        Velocities[target] = Velocities[source];
+        AngularVelocities[target] = AngularVelocities[source];
+        Extents[target] = Extents[source];
+        KinematicTargets[target] = KinematicTargets[source];
+        Layers[target] = Layers[source];
+        PlaneHeights[target] = PlaneHeights[source];
+    }
+
+    void ComponentStorage::Resize(size_t count) noexcept
+    {
+        //
+        // Only shrinking is supported; new slots are added by Push.
+        //
+        IDs.resize(count);
+        Objects.resize(count);
+        RigidBodies.resize(count);
+        Types.resize(count);
+        Flags.resize(count);
+        Positions.resize(count);
+        Orientations.resize(count);
+        PreviousPositions.resize(count);
+        PreviousOrientations.resize(count);
+        Scales.resize(count);
+        Velocities.resize(count);
+        AngularVelocities.resize(count);
+        Extents.resize(count);
+        KinematicTargets.resize(count);
+        Layers.resize(count);
+        PlaneHeights.resize(count);
+    }
+
+    void ComponentStorage::Clear() noexcept
+    {
+        Resize(0);
+    }
+}
\ No newline at end of file
@@ -6,17 +6,64 @@
 
 #include <Core.World/GameObject.hxx>
 #include <Core.World/Physics.hxx>
+#include <Core.World/Scene.hxx>
 
 namespace Core::World
 {
     GameObject::GameObject(GameObjectTypeID typeID) noexcept
-        : TypeID{ typeID }
+        : m_RigidBody{ nullptr }
+        , m_Shape{ nullptr }
+        , m_ComponentFlags{ ComponentFlags::Update }
+        , m_Scale{ 1.0F, 1.0F, 1.0F, 0.0F }
+        , m_TimeToLive{ 0.0F }
+        , m_Body{}
+        , m_Mesh{}
+        , m_Material{}
+        , TypeID{ typeID }
+        , m_Scene{ nullptr }
+        , m_Pool{ nullptr }
+        , m_ID{ InvalidGameObjectID }
         , m_MarkedToRemove{ false }
     {
+        //
+        // No rigid body until object describes one.
+        //
+        m_Body.Orientation = DirectX::XMFLOAT4A{ 0.0F, 0.0F, 0.0F, 1.0F };
     }
 
     GameObject::~GameObject() noexcept
     {
+        if (m_RigidBody != nullptr)
+        {
+            m_RigidBody->release();
+        }
+    }
+
+    void GameObject::Destroy() noexcept
+    {
+        if (m_Scene != nullptr && m_Scene->IsUpdating())
+        {
+            m_Scene->DeferDestroy(this);
+        }
+        else if (m_Scene != nullptr && !m_MarkedToRemove)
+        {
+            //
+            // Scene removes only objects from this list, instead of scanning all of them.
+            //
+            m_MarkedToRemove = true;
+            m_Scene->m_PendingRemovals.push_back(m_ID);
+        }
+    }
+
+    void XM_CALLCONV GameObject::SetKinematicTarget(DirectX::FXMVECTOR position) noexcept
+    {
+        CORE_ASSERT(m_Scene != nullptr);
+
+        //
+        // Object owns its slot, so this is safe during parallel update.
+        //
+        const auto index = m_Scene->GetComponentIndex(m_ID);
+        DirectX::XMStoreFloat4A(&m_Scene->m_Components.KinematicTargets[index], position);
     }
 
     void GameObject::OnUpdate(float deltaTime) noexcept
@@ -24,29 +71,51 @@ namespace Core::World
         (void)deltaTime;
     }
 
+#if !defined(CORE_HEADLESS)
     void GameObject::OnRender(const Rendering::CommandListRef& commandList) noexcept
     {
-        (void)commandList;
+        if (m_Mesh != nullptr && m_Material != nullptr)
+        {
+            //
+            // Bind material.
+            //
+            m_Material->Bind(commandList);
+
+            //
+            // And render mesh.
+            //
+            m_Mesh->Bind(commandList);
+            m_Mesh->Render(commandList);
+        }
     }
+#endif
 
     DirectX::XMMATRIX XM_CALLCONV GameObject::GetTransform() const noexcept
     {
-        if (m_RigidBody != nullptr)
+        if (m_Scene != nullptr)
         {
-            return World::Converters::PxTransformToXMMATRIX(m_RigidBody->getGlobalPose());
+            //
+            // Object on scene has its transform in component storage.
+            //
+            return m_Scene->GetComponents().GetTransform(m_Scene->GetComponentIndex(m_ID));
         }
 
-        return DirectX::XMMatrixIdentity();
+        return DirectX::XMMatrixAffineTransformation(
+            DirectX::XMLoadFloat4A(&m_Scale),
+            DirectX::XMVectorZero(),
+            DirectX::XMLoadFloat4A(&m_Body.Orientation),
+            DirectX::XMLoadFloat4A(&m_Body.Position)
+        );
     }
 
     DirectX::XMVECTOR XM_CALLCONV GameObject::GetPosition() const noexcept
     {
-        if (m_RigidBody != nullptr)
+        if (m_Scene != nullptr)
         {
-            return World::Converters::PxVec3ToXMVECTOR(m_RigidBody->getGlobalPose().p);
+            return DirectX::XMLoadFloat4A(&m_Scene->GetComponents().Positions[m_Scene->GetComponentIndex(m_ID)]);
         }
 
-        return DirectX::XMVectorZero();
+        return DirectX::XMLoadFloat4A(&m_Body.Position);
     }
 
     void GameObject::OnCollision(GameObject* other) noexcept
@@ -56,12 +125,9 @@ namespace Core::World
 
     void GameObject::OnRemoveFromScene(physx::PxScene* scene) noexcept
     {
-        if (m_RigidBody != nullptr)
-        {
-            //
-            // Remove internal actor from scene.
-            //
-            scene->removeActor(*m_RigidBody);
-        }
+        //
+        // Scene removes rigid bodies of all removed objects at once.
+        //
+        (void)scene;
     }
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core.World/HandleTable.hxx>
+
+namespace Core::World
+{
+    GameObjectID HandleTable::Allocate(uint32_t dense) noexcept
+    {
+        uint32_t slot;
+
+        if (!m_FreeSlots.empty())
+        {
+            //
+            // Reuse released slot; its generation was already bumped.
+            //
+            slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        }
+        else
+        {
+            CORE_ASSERT(m_Slots.size() < MaxSlots);
+
+            slot = static_cast<uint32_t>(m_Slots.size());
+            m_Slots.push_back(Slot{ InvalidIndex, 0 });
+        }
+
+        auto& entry = m_Slots[slot];
+        entry.Dense = dense;
+
+        return MakeID(slot, entry.Generation);
+    }
+
+    void HandleTable::Release(GameObjectID id) noexcept
+    {
+        CORE_ASSERT(IsValid(id));
+
+        const auto slot = GetSlot(id);
+        auto& entry = m_Slots[slot];
+
+        //
+        // Invalidate all outstanding handles to this slot.
+        //
+        entry.Dense = InvalidIndex;
+        ++entry.Generation;
+
+        m_FreeSlots.push_back(slot);
+    }
+
+    void HandleTable::Clear() noexcept
+    {
+        //
+        // Keep generations, so handles from before clear stay invalid.
+        //
+        m_FreeSlots.clear();
+
+        for (uint32_t slot = static_cast<uint32_t>(m_Slots.size()); slot > 0; --slot)
+        {
+            auto& entry = m_Slots[slot - 1];
+
+            if (entry.Dense != InvalidIndex)
+            {
+                entry.Dense = InvalidIndex;
+                ++entry.Generation;
+            }
+
+            m_FreeSlots.push_back(slot - 1);
+        }
+    }
+}
\ No newline at end of file
@@ -7,10 +7,13 @@
 #include <Core.World/Physics.hxx>
 #include <Core.Diagnostics/Debug.hxx>
 #include <Core.Diagnostics/Trace.hxx>
+#include <Core/Jobs.hxx>
 #include <PxPhysics.h>
 #include <PxPhysicsAPI.h>
 #include <physxprofilesdk/PxProfileZoneManager.h>
 #include <extensions/PxDefaultSimulationFilterShader.h>
+#include <cmath>
+#include <unordered_map>
 
 namespace Core::World
 {
@@ -25,11 +28,185 @@ namespace Core::World
         physx::PxFoundation* g_PxFoundation{};
         physx::PxPhysics* g_PxPhysics{};
         physx::PxProfileZoneManager* g_PxProfileZoneManager{};
-        physx::PxDefaultCpuDispatcher* g_PxDefaultCpuDispatcher{};
+        //
+        // Runs PhysX tasks on engine job system, so both share the same worker threads.
+        //
+        class JobsCpuDispatcher final : public physx::PxCpuDispatcher
+        {
+        private:
+            //
+            // Worker 0 is main thread, which blocks in fetchResults; only remaining workers run
+            // PhysX tasks.
+            //
+            static uint32_t GetBackgroundWorkerCount() noexcept
+            {
+                const auto count = Core::Jobs::GetWorkerCount();
+                return (count > 0) ? (count - 1) : 0;
+            }
+
+        public:
+            virtual void submitTask(physx::PxBaseTask& task) override final
+            {
+                if (GetBackgroundWorkerCount() == 0)
+                {
+                    //
+                    // There is nobody else to run the task.
+                    //
+                    task.run();
+                    task.release();
+                    return;
+                }
+
+                auto pointer = &task;
+
+                auto job = Core::Jobs::Create([](Core::Job*, const void* data)
+                {
+                    auto task = *static_cast<physx::PxBaseTask* const*>(data);
+                    task->run();
+                    task->release();
+                }, &pointer, sizeof(pointer));
+
+                Core::Jobs::Run(job);
+            }
+
+            virtual physx::PxU32 getWorkerCount() const override final
+            {
+                return GetBackgroundWorkerCount();
+            }
+        };
+
+        JobsCpuDispatcher g_JobsCpuDispatcher{};
         physx::PxTolerancesScale g_PxToleranceScale{};
 
         physx::PxMaterial* g_PxDefaultMaterial{};
 
+        //
+        // Shape cache.
+        //
+        // Extents are quantised, so shapes with almost the same size share single PxShape.
+        //
+        constexpr const float ShapeQuantum = 1.0F / 256.0F;
+
+        enum class ShapeKind : uint32_t
+        {
+            Box,
+            Sphere,
+        };
+
+        struct ShapeKey final
+        {
+            ShapeKind Kind;
+            int32_t Extent[3];
+            CollisionLayer Layer;
+            const physx::PxMaterial* Material;
+
+            bool operator == (const ShapeKey& other) const noexcept
+            {
+                return Kind == other.Kind
+                    && Extent[0] == other.Extent[0]
+                    && Extent[1] == other.Extent[1]
+                    && Extent[2] == other.Extent[2]
+                    && Layer == other.Layer
+                    && Material == other.Material;
+            }
+        };
+
+        struct ShapeKeyHash final
+        {
+            size_t operator () (const ShapeKey& key) const noexcept
+            {
+                //
+                // FNV-1a over key fields.
+                //
+                uint64_t hash = 14695981039346656037ULL;
+
+                auto combine = [&](uint64_t value)
+                {
+                    hash ^= value;
+                    hash *= 1099511628211ULL;
+                };
+
+                combine(static_cast<uint64_t>(key.Kind));
+                combine(static_cast<uint32_t>(key.Extent[0]));
+                combine(static_cast<uint32_t>(key.Extent[1]));
+                combine(static_cast<uint32_t>(key.Extent[2]));
+                combine(key.Layer);
+                combine(reinterpret_cast<uintptr_t>(key.Material));
+
+                return static_cast<size_t>(hash);
+            }
+        };
+
+        std::unordered_map<ShapeKey, physx::PxShape*, ShapeKeyHash> g_ShapeCache{};
+
+        //
+        // Collision matrix rows; bit N of row is set when layer collides with layer N. Whole matrix
+        // is passed to filter shader as its constant block.
+        //
+        struct CollisionMatrix final
+        {
+            uint32_t Resolve[MaxCollisionLayers];
+            uint32_t Notify[MaxCollisionLayers];
+        };
+
+        CollisionMatrix g_CollisionMatrix{};
+
+        //
+        // Set once first PhysX scene copied matrix.
+        //
+        bool g_IsCollisionMatrixFrozen{ false };
+
+        //
+        // Filter data carries only layer bit in word0, so shapes never need refiltering.
+        //
+        physx::PxFilterData MakeFilterData(CollisionLayer layer) noexcept
+        {
+            return physx::PxFilterData{ 1U << layer, 0, 0, 0 };
+        }
+
+        CollisionLayer GetLayerFromBit(uint32_t bit) noexcept
+        {
+            CollisionLayer layer = 0;
+
+            while ((bit >>= 1) != 0)
+            {
+                ++layer;
+            }
+
+            return layer;
+        }
+
+        int32_t QuantiseExtent(float value) noexcept
+        {
+            return static_cast<int32_t>(std::lround(value / ShapeQuantum));
+        }
+
+        float DequantiseExtent(int32_t value) noexcept
+        {
+            return static_cast<float>(value) * ShapeQuantum;
+        }
+
+        physx::PxShape* InternShape(const ShapeKey& key, const physx::PxGeometry& geometry, physx::PxMaterial& material) noexcept
+        {
+            auto it = g_ShapeCache.find(key);
+
+            if (it != std::end(g_ShapeCache))
+            {
+                return it->second;
+            }
+
+            //
+            // Create shared shape. Cache holds its initial reference.
+            //
+            auto shape = g_PxPhysics->createShape(geometry, material, false);
+            CORE_ASSERT(shape != nullptr);
+
+            shape->setSimulationFilterData(MakeFilterData(key.Layer));
+
+            g_ShapeCache.emplace(key, shape);
+            return shape;
+        }
+
         static physx::PxFilterFlags physicsFilterShader(
             physx::PxFilterObjectAttributes attributes0,
             physx::PxFilterData filterData0,
@@ -40,17 +217,40 @@ namespace Core::World
             physx::PxU32 constantBlockSize)
         {
             (void)attributes0;
-            (void)filterData0;
             (void)attributes1;
-            (void)filterData1;
-            (void)constantBlock;
             (void)constantBlockSize;
 
+            CORE_ASSERT(constantBlockSize == sizeof(CollisionMatrix));
+
+            const auto& matrix = *static_cast<const CollisionMatrix*>(constantBlock);
+
             //
-            // Want resolve contacts and notify about collisions.
+            // Matrix is symmetric, so checking one side is enough.
             //
-            pairFlags = physx::PxPairFlag::eRESOLVE_CONTACTS;
-            pairFlags |= physx::PxPairFlag::eNOTIFY_TOUCH_FOUND;
+            const auto layer1 = GetLayerFromBit(filterData1.word0);
+            const auto resolve = (filterData0.word0 & matrix.Resolve[layer1]) != 0;
+            const auto notify = (filterData0.word0 & matrix.Notify[layer1]) != 0;
+
+            if (!resolve && !notify)
+            {
+                //
+                // Game doesn't care about this pair at all; drop it before narrowphase.
+                //
+                return physx::PxFilterFlag::eKILL;
+            }
+
+            pairFlags = physx::PxPairFlags();
+
+            if (resolve)
+            {
+                pairFlags |= physx::PxPairFlag::eRESOLVE_CONTACTS;
+            }
+
+            if (notify)
+            {
+                pairFlags |= physx::PxPairFlag::eNOTIFY_TOUCH_FOUND;
+            }
+
             return physx::PxFilterFlags();
         }
     }
@@ -64,10 +264,6 @@ namespace Core::World
         CORE_ASSERT(g_PxFoundation != nullptr);
         CORE_TRACE_MESSAGE(Info, "[PhysX] Initialized PxFoundation");
 
-        g_PxDefaultCpuDispatcher = physx::PxDefaultCpuDispatcherCreate(1);
-        CORE_ASSERT(g_PxDefaultCpuDispatcher != nullptr);
-        CORE_TRACE_MESSAGE(Info, "[PhysX] Allocated PxDefaultCpuDispatcher");
-
         g_PxProfileZoneManager = &physx::PxProfileZoneManager::createProfileZoneManager(g_PxFoundation);
         CORE_ASSERT(g_PxProfileZoneManager != nullptr);
         CORE_TRACE_MESSAGE(Info, "[PhysX] Allocated PxProfileZoneManager");
@@ -79,10 +275,34 @@ namespace Core::World
         g_PxDefaultMaterial = g_PxPhysics->createMaterial(0.5F, 0.5F, 0.1F);
         CORE_ASSERT(g_PxDefaultMaterial != nullptr);
         CORE_TRACE_MESSAGE(Info, "[PhysX] Allocated PxDefaultMaterial");
+
+        //
+        // Everything collides with everything until game says otherwise.
+        //
+        for (auto& mask : g_CollisionMatrix.Resolve)
+        {
+            mask = ~0U;
+        }
+
+        for (auto& mask : g_CollisionMatrix.Notify)
+        {
+            mask = ~0U;
+        }
     }
 
     void Physics::Shutdown() noexcept
     {
+        //
+        // Release cached shapes.
+        //
+        for (auto& entry : g_ShapeCache)
+        {
+            entry.second->release();
+        }
+
+        g_ShapeCache.clear();
+        CORE_TRACE_MESSAGE(Info, "[PhysX] Released shape cache");
+
         //
         // And standard physx shutdown
         //
@@ -95,15 +315,19 @@ namespace Core::World
         g_PxProfileZoneManager->release();
         CORE_TRACE_MESSAGE(Info, "[PhysX] Deallocate PxProfileZoneManager");
 
-        g_PxDefaultCpuDispatcher->release();
-        CORE_TRACE_MESSAGE(Info, "[PhysX] Deallocate PxDefaultCpuDispatcher");
-
         g_PxFoundation->release();
         CORE_TRACE_MESSAGE(Info, "[PhysX] Shutdown PxFoundation");
     }
 
-    Core::World::SceneRef Physics::MakeScene(const DirectX::XMFLOAT3& gravity) noexcept
+    Core::World::SceneRef Physics::MakeScene(const DirectX::XMFLOAT3& gravity, PhysicsBackend backend) noexcept
     {
+        if (backend == PhysicsBackend::Planar)
+        {
+            CORE_TRACE_MESSAGE(Info, "[Physics] Create new planar scene");
+
+            return MakeRef<Scene>(gravity);
+        }
+
         CORE_TRACE_MESSAGE(Info, "[PhysX] Create new scene");
 
         physx::PxSceneDesc desc{ g_PxToleranceScale };
@@ -112,9 +336,16 @@ namespace Core::World
         // Default scene params.
         //
         desc.gravity = physx::PxVec3(gravity.x, gravity.y, gravity.z);
-        desc.cpuDispatcher = g_PxDefaultCpuDispatcher;
+        desc.cpuDispatcher = &g_JobsCpuDispatcher;
         desc.flags |= physx::PxSceneFlag::eENABLE_ACTIVETRANSFORMS;
         desc.filterShader = physicsFilterShader;
+        desc.filterShaderData = &g_CollisionMatrix;
+        desc.filterShaderDataSize = sizeof(g_CollisionMatrix);
+
+        //
+        // Scene keeps its own copy of matrix.
+        //
+        g_IsCollisionMatrixFrozen = true;
 
         //
         // Create actual scene.
@@ -132,25 +363,207 @@ namespace Core::World
     }
 
 
-    physx::PxShape* Physics::MakeBoxCollider(DirectX::FXMVECTOR extent) noexcept
+    physx::PxShape* Physics::MakeBoxCollider(DirectX::FXMVECTOR extent, CollisionLayer layer, physx::PxMaterial* material) noexcept
     {
+        CORE_ASSERT(layer < MaxCollisionLayers);
+
+        if (material == nullptr)
+        {
+            material = g_PxDefaultMaterial;
+        }
+
         //
-        // Create simple box collider shape.
+        // Get simple box collider shape.
         //
         DirectX::XMFLOAT3A values;
         DirectX::XMStoreFloat3A(&values, extent);
 
-        auto shape = g_PxPhysics->createShape(physx::PxBoxGeometry(values.x, values.y, values.z), *g_PxDefaultMaterial);
-        return shape;
+        const ShapeKey key{
+            ShapeKind::Box,
+            { QuantiseExtent(values.x), QuantiseExtent(values.y), QuantiseExtent(values.z) },
+            layer,
+            material
+        };
+
+        const physx::PxBoxGeometry geometry{
+            DequantiseExtent(key.Extent[0]),
+            DequantiseExtent(key.Extent[1]),
+            DequantiseExtent(key.Extent[2])
+        };
+
+        return InternShape(key, geometry, *material);
     }
 
-    physx::PxShape* Physics::MakeSphereCollider(float radius) noexcept
+    physx::PxShape* Physics::MakeSphereCollider(float radius, CollisionLayer layer, physx::PxMaterial* material) noexcept
     {
+        CORE_ASSERT(layer < MaxCollisionLayers);
+
+        if (material == nullptr)
+        {
+            material = g_PxDefaultMaterial;
+        }
+
         //
-        // Create sphere collider.
+        // Get sphere collider.
         //
-        auto shape = g_PxPhysics->createShape(physx::PxSphereGeometry(radius), *g_PxDefaultMaterial);
-        return shape;
+        const ShapeKey key{
+            ShapeKind::Sphere,
+            { QuantiseExtent(radius), 0, 0 },
+            layer,
+            material
+        };
+
+        const physx::PxSphereGeometry geometry{ DequantiseExtent(key.Extent[0]) };
+
+        return InternShape(key, geometry, *material);
+    }
+
+    size_t Physics::GetCachedShapeCount() noexcept
+    {
+        return g_ShapeCache.size();
+    }
+
+    size_t Physics::GetLiveShapeCount() noexcept
+    {
+        size_t result = 0;
+
+        for (auto& entry : g_ShapeCache)
+        {
+            //
+            // Only cache holds reference to unused shape.
+            //
+            if (entry.second->getReferenceCount() > 1)
+            {
+                ++result;
+            }
+        }
+
+        return result;
+    }
+
+    size_t Physics::ReleaseUnusedShapes() noexcept
+    {
+        size_t result = 0;
+
+        for (auto it = std::begin(g_ShapeCache); it != std::end(g_ShapeCache);)
+        {
+            if (it->second->getReferenceCount() == 1)
+            {
+                it->second->release();
+                it = g_ShapeCache.erase(it);
+                ++result;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        return result;
+    }
+
+    void Physics::SetCollisionResponse(CollisionLayer layer0, CollisionLayer layer1, CollisionResponse response) noexcept
+    {
+        CORE_ASSERT(layer0 < MaxCollisionLayers);
+        CORE_ASSERT(layer1 < MaxCollisionLayers);
+        CORE_ASSERT(!g_IsCollisionMatrixFrozen);
+
+        auto update = [](uint32_t* masks, CollisionLayer row, CollisionLayer column, bool value)
+        {
+            if (value)
+            {
+                masks[row] |= (1U << column);
+            }
+            else
+            {
+                masks[row] &= ~(1U << column);
+            }
+        };
+
+        const auto resolve = (response & CollisionResponse::Resolve) == CollisionResponse::Resolve;
+        const auto notify = (response & CollisionResponse::Notify) == CollisionResponse::Notify;
+
+        update(g_CollisionMatrix.Resolve, layer0, layer1, resolve);
+        update(g_CollisionMatrix.Resolve, layer1, layer0, resolve);
+        update(g_CollisionMatrix.Notify, layer0, layer1, notify);
+        update(g_CollisionMatrix.Notify, layer1, layer0, notify);
+    }
+
+    CollisionResponse Physics::GetCollisionResponse(CollisionLayer layer0, CollisionLayer layer1) noexcept
+    {
+        CORE_ASSERT(layer0 < MaxCollisionLayers);
+        CORE_ASSERT(layer1 < MaxCollisionLayers);
+
+        auto result = CollisionResponse::None;
+
+        if ((g_CollisionMatrix.Resolve[layer0] & (1U << layer1)) != 0)
+        {
+            result |= CollisionResponse::Resolve;
+        }
+
+        if ((g_CollisionMatrix.Notify[layer0] & (1U << layer1)) != 0)
+        {
+            result |= CollisionResponse::Notify;
+        }
+
+        return result;
+    }
+
+    uint32_t Physics::GetCollisionMask(CollisionLayer layer, CollisionResponse response) noexcept
+    {
+        CORE_ASSERT(layer < MaxCollisionLayers);
+
+        uint32_t result = 0;
+
+        if ((response & CollisionResponse::Resolve) == CollisionResponse::Resolve)
+        {
+            result |= g_CollisionMatrix.Resolve[layer];
+        }
+
+        if ((response & CollisionResponse::Notify) == CollisionResponse::Notify)
+        {
+            result |= g_CollisionMatrix.Notify[layer];
+        }
+
+        return result;
+    }
+
+    void Physics::ApplyPlanarConstraints(ComponentStorage& components) noexcept
+    {
+        const auto count = components.GetCount();
+
+        auto flags = components.Flags.data();
+        auto rigidBodies = components.RigidBodies.data();
+        auto positions = components.Positions.data();
+        auto velocities = components.Velocities.data();
+        auto heights = components.PlaneHeights.data();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if ((flags[i] & ComponentFlags::PlanarMotion) != ComponentFlags::PlanarMotion || rigidBodies[i] == nullptr)
+            {
+                continue;
+            }
+
+            //
+            // Most bodies don't leave plane at all; touch actor only when solver moved it.
+            //
+            if (positions[i].y != heights[i])
+            {
+                positions[i].y = heights[i];
+
+                auto pose = rigidBodies[i]->getGlobalPose();
+                pose.p.y = heights[i];
+                rigidBodies[i]->setGlobalPose(pose);
+            }
+
+            if (velocities[i].y != 0.0F)
+            {
+                velocities[i].y = 0.0F;
+
+                rigidBodies[i]->setLinearVelocity(Converters::XMVECTORToPxVec3(DirectX::XMLoadFloat4A(&velocities[i])));
+            }
+        }
     }
 
     physx::PxMaterial* Physics::GetDefaultMaterial() noexcept
@@ -0,0 +1,513 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core.World/PlanarPhysics.hxx>
+#include <Core.World/Physics.hxx>
+#include <Core.Diagnostics/Debug.hxx>
+#include <Core/Jobs.hxx>
+#include <algorithm>
+#include <cmath>
+
+namespace Core::World
+{
+    namespace
+    {
+        bool HasFlag(ComponentFlags flags, ComponentFlags flag) noexcept
+        {
+            return (flags & flag) == flag;
+        }
+
+        uint64_t MakePairKey(GameObjectID first, GameObjectID second) noexcept
+        {
+            if (first > second)
+            {
+                std::swap(first, second);
+            }
+
+            return (static_cast<uint64_t>(first) << 32) | second;
+        }
+    }
+
+    PlanarPhysics::PlanarPhysics(const DirectX::XMFLOAT3& gravity) noexcept
+        : m_Gravity{ gravity }
+    {
+    }
+
+    void PlanarPhysics::Simulate(ComponentStorage& components, float deltaTime, std::vector<Contact>& contacts) noexcept
+    {
+        Integrate(components, deltaTime);
+        BuildColliders(components);
+        FindCandidates();
+        TestCandidates();
+        ResolveContacts(components, contacts);
+    }
+
+    void PlanarPhysics::Integrate(ComponentStorage& components, float deltaTime) noexcept
+    {
+        const auto gravity = DirectX::XMVectorScale(DirectX::XMLoadFloat3(&m_Gravity), deltaTime);
+        const auto inverseDeltaTime = 1.0F / deltaTime;
+
+        Jobs::ParallelFor(components.GetCount(), IntegrateGrainSize, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto flags = components.Flags[i];
+
+                if (!HasFlag(flags, ComponentFlags::RigidBody))
+                {
+                    continue;
+                }
+
+                auto position = DirectX::XMLoadFloat4A(&components.Positions[i]);
+
+                if (HasFlag(flags, ComponentFlags::Kinematic))
+                {
+                    //
+                    // Kinematic body jumps to its target; velocity is derived from displacement, so
+                    // it pushes dynamic bodies correctly.
+                    //
+                    const auto target = DirectX::XMLoadFloat4A(&components.KinematicTargets[i]);
+
+                    DirectX::XMStoreFloat4A(&components.Velocities[i], DirectX::XMVectorScale(DirectX::XMVectorSubtract(target, position), inverseDeltaTime));
+                    DirectX::XMStoreFloat4A(&components.Positions[i], target);
+                    continue;
+                }
+
+                auto velocity = DirectX::XMLoadFloat4A(&components.Velocities[i]);
+
+                if (!HasFlag(flags, ComponentFlags::DrivenVelocity))
+                {
+                    velocity = DirectX::XMVectorAdd(velocity, gravity);
+                }
+
+                if (HasFlag(flags, ComponentFlags::PlanarMotion))
+                {
+                    velocity = DirectX::XMVectorSetY(velocity, 0.0F);
+                }
+
+                position = DirectX::XMVectorMultiplyAdd(velocity, DirectX::XMVectorReplicate(deltaTime), position);
+
+                if (HasFlag(flags, ComponentFlags::PlanarMotion))
+                {
+                    position = DirectX::XMVectorSetY(position, components.PlaneHeights[i]);
+                }
+
+                DirectX::XMStoreFloat4A(&components.Positions[i], position);
+                DirectX::XMStoreFloat4A(&components.Velocities[i], velocity);
+
+                //
+                // Rotate by angular velocity over whole step.
+                //
+                const auto angularVelocity = DirectX::XMLoadFloat4A(&components.AngularVelocities[i]);
+                const auto angle = DirectX::XMVectorGetX(DirectX::XMVector3Length(angularVelocity)) * deltaTime;
+
+                if (angle > 0.0F)
+                {
+                    auto orientation = DirectX::XMLoadFloat4A(&components.Orientations[i]);
+                    orientation = DirectX::XMQuaternionMultiply(orientation, DirectX::XMQuaternionRotationAxis(angularVelocity, angle));
+                    orientation = DirectX::XMQuaternionNormalize(orientation);
+
+                    DirectX::XMStoreFloat4A(&components.Orientations[i], orientation);
+                }
+            }
+        });
+    }
+
+    void PlanarPhysics::BuildColliders(const ComponentStorage& components) noexcept
+    {
+        //
+        // Gather slots in component order, so results don't depend on thread scheduling.
+        //
+        m_Indices.clear();
+
+        const auto count = components.GetCount();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (HasFlag(components.Flags[i], ComponentFlags::RigidBody) && components.Extents[i].x > 0.0F && components.Extents[i].z > 0.0F)
+            {
+                const auto layer = components.Layers[i];
+
+                //
+                // Matrix is symmetric; layer which doesn't collide with anything never takes part
+                // in any pair.
+                //
+                if ((Physics::GetCollisionMask(layer, CollisionResponse::Resolve) | Physics::GetCollisionMask(layer, CollisionResponse::Notify)) != 0)
+                {
+                    m_Indices.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+
+        const auto slots = m_Indices.size();
+
+        m_CenterX.resize(slots);
+        m_CenterZ.resize(slots);
+        m_AxisX.resize(slots);
+        m_AxisZ.resize(slots);
+        m_ExtentX.resize(slots);
+        m_ExtentZ.resize(slots);
+        m_InverseMass.resize(slots);
+        m_LayerBits.resize(slots);
+        m_ResolveMasks.resize(slots);
+        m_NotifyMasks.resize(slots);
+        m_MaxX.resize(slots);
+        m_MinZ.resize(slots);
+        m_MaxZ.resize(slots);
+        m_SortKeys.resize(slots);
+
+        Jobs::ParallelFor(slots, IntegrateGrainSize, [&](size_t begin, size_t end)
+        {
+            const auto unitX = DirectX::XMVectorSet(1.0F, 0.0F, 0.0F, 0.0F);
+
+            for (size_t slot = begin; slot < end; ++slot)
+            {
+                const auto index = m_Indices[slot];
+                const auto& position = components.Positions[index];
+                const auto& extent = components.Extents[index];
+
+                //
+                // Local X axis projected to plane.
+                //
+                DirectX::XMFLOAT4A axis;
+                DirectX::XMStoreFloat4A(&axis, DirectX::XMVector3Rotate(unitX, DirectX::XMLoadFloat4A(&components.Orientations[index])));
+
+                auto axisX = axis.x;
+                auto axisZ = axis.z;
+                const auto length = std::sqrt(axisX * axisX + axisZ * axisZ);
+
+                if (length > 1.0e-4F)
+                {
+                    axisX /= length;
+                    axisZ /= length;
+                }
+                else
+                {
+                    axisX = 1.0F;
+                    axisZ = 0.0F;
+                }
+
+                //
+                // Second axis is (-axisZ, axisX), so bounds extent follows from absolute components.
+                //
+                const auto halfX = std::abs(axisX) * extent.x + std::abs(axisZ) * extent.z;
+                const auto halfZ = std::abs(axisZ) * extent.x + std::abs(axisX) * extent.z;
+
+                const auto layer = components.Layers[index];
+
+                m_CenterX[slot] = position.x;
+                m_CenterZ[slot] = position.z;
+                m_AxisX[slot] = axisX;
+                m_AxisZ[slot] = axisZ;
+                m_ExtentX[slot] = extent.x;
+                m_ExtentZ[slot] = extent.z;
+                m_InverseMass[slot] = HasFlag(components.Flags[index], ComponentFlags::Kinematic) ? 0.0F : 1.0F / (4.0F * extent.x * extent.z);
+                m_LayerBits[slot] = 1U << layer;
+                m_ResolveMasks[slot] = Physics::GetCollisionMask(layer, CollisionResponse::Resolve);
+                m_NotifyMasks[slot] = Physics::GetCollisionMask(layer, CollisionResponse::Notify);
+                m_MaxX[slot] = position.x + halfX;
+                m_MinZ[slot] = position.z - halfZ;
+                m_MaxZ[slot] = position.z + halfZ;
+                m_SortKeys[slot] = std::make_pair(position.x - halfX, static_cast<uint32_t>(slot));
+            }
+        });
+    }
+
+    void PlanarPhysics::FindCandidates() noexcept
+    {
+        //
+        // Sort bounds along X. Ties are broken by slot, so order is deterministic.
+        //
+        std::sort(std::begin(m_SortKeys), std::end(m_SortKeys));
+
+        const auto slots = m_SortKeys.size();
+
+        m_SortedMinX.resize(slots);
+        m_SortedMaxX.resize(slots);
+        m_SortedMinZ.resize(slots);
+        m_SortedMaxZ.resize(slots);
+
+        for (size_t i = 0; i < slots; ++i)
+        {
+            const auto slot = m_SortKeys[i].second;
+
+            m_SortedMinX[i] = m_SortKeys[i].first;
+            m_SortedMaxX[i] = m_MaxX[slot];
+            m_SortedMinZ[i] = m_MinZ[slot];
+            m_SortedMaxZ[i] = m_MaxZ[slot];
+        }
+
+        //
+        // Sweep: each interval is tested only against intervals starting before it ends.
+        //
+        const auto chunks = (slots + SweepGrainSize - 1) / SweepGrainSize;
+
+        if (m_ChunkCandidates.size() < chunks)
+        {
+            m_ChunkCandidates.resize(chunks);
+        }
+
+        Jobs::ParallelChunks(slots, SweepGrainSize, [&](size_t chunk, size_t begin, size_t end)
+        {
+            auto& candidates = m_ChunkCandidates[chunk];
+            candidates.clear();
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto first = m_SortKeys[i].second;
+                const auto maxX = m_SortedMaxX[i];
+                const auto minZ = m_SortedMinZ[i];
+                const auto maxZ = m_SortedMaxZ[i];
+
+                for (size_t j = i + 1; j < slots && m_SortedMinX[j] <= maxX; ++j)
+                {
+                    if (m_SortedMinZ[j] > maxZ || m_SortedMaxZ[j] < minZ)
+                    {
+                        continue;
+                    }
+
+                    const auto second = m_SortKeys[j].second;
+
+                    if (((m_ResolveMasks[first] | m_NotifyMasks[first]) & m_LayerBits[second]) == 0)
+                    {
+                        continue;
+                    }
+
+                    if (m_InverseMass[first] == 0.0F && m_InverseMass[second] == 0.0F)
+                    {
+                        //
+                        // Kinematic pairs don't interact.
+                        //
+                        continue;
+                    }
+
+                    candidates.push_back(Candidate{ (std::min)(first, second), (std::max)(first, second) });
+                }
+            }
+        });
+
+        m_Candidates.clear();
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            m_Candidates.insert(std::end(m_Candidates), std::begin(m_ChunkCandidates[chunk]), std::end(m_ChunkCandidates[chunk]));
+        }
+    }
+
+    void PlanarPhysics::TestCandidates() noexcept
+    {
+        const auto count = m_Candidates.size();
+        const auto chunks = (count + NarrowphaseGrainSize - 1) / NarrowphaseGrainSize;
+
+        if (m_ChunkManifolds.size() < chunks)
+        {
+            m_ChunkManifolds.resize(chunks);
+        }
+
+        Jobs::ParallelChunks(count, NarrowphaseGrainSize, [&](size_t chunk, size_t begin, size_t end)
+        {
+            auto& manifolds = m_ChunkManifolds[chunk];
+            manifolds.clear();
+
+            const auto zero = DirectX::XMVectorZero();
+
+            for (size_t batch = begin; batch < end; batch += 4)
+            {
+                //
+                // Separating axis test of four pairs at once; one pair per lane. Tail lanes repeat
+                // last pair and are ignored.
+                //
+                uint32_t first[4];
+                uint32_t second[4];
+
+                const auto lanes = (std::min)(end - batch, size_t{ 4 });
+
+                for (size_t lane = 0; lane < 4; ++lane)
+                {
+                    const auto& candidate = m_Candidates[batch + (std::min)(lane, lanes - 1)];
+                    first[lane] = candidate.First;
+                    second[lane] = candidate.Second;
+                }
+
+                auto gather = [](const std::vector<float>& values, const uint32_t* slots)
+                {
+                    return DirectX::XMVectorSet(values[slots[0]], values[slots[1]], values[slots[2]], values[slots[3]]);
+                };
+
+                const auto dx = DirectX::XMVectorSubtract(gather(m_CenterX, second), gather(m_CenterX, first));
+                const auto dz = DirectX::XMVectorSubtract(gather(m_CenterZ, second), gather(m_CenterZ, first));
+
+                const auto uax = gather(m_AxisX, first);
+                const auto uaz = gather(m_AxisZ, first);
+                const auto ubx = gather(m_AxisX, second);
+                const auto ubz = gather(m_AxisZ, second);
+
+                const auto eax = gather(m_ExtentX, first);
+                const auto eaz = gather(m_ExtentZ, first);
+                const auto ebx = gather(m_ExtentX, second);
+                const auto ebz = gather(m_ExtentZ, second);
+
+                //
+                // With second axes perpendicular to first ones, all projections reduce to cosine and
+                // sine of relative rotation.
+                //
+                const auto c = DirectX::XMVectorAbs(DirectX::XMVectorMultiplyAdd(uax, ubx, DirectX::XMVectorMultiply(uaz, ubz)));
+                const auto s = DirectX::XMVectorAbs(DirectX::XMVectorSubtract(DirectX::XMVectorMultiply(uax, ubz), DirectX::XMVectorMultiply(uaz, ubx)));
+
+                //
+                // Signed distances of centers along each axis.
+                //
+                const auto distanceUA = DirectX::XMVectorMultiplyAdd(dx, uax, DirectX::XMVectorMultiply(dz, uaz));
+                const auto distanceVA = DirectX::XMVectorSubtract(DirectX::XMVectorMultiply(dz, uax), DirectX::XMVectorMultiply(dx, uaz));
+                const auto distanceUB = DirectX::XMVectorMultiplyAdd(dx, ubx, DirectX::XMVectorMultiply(dz, ubz));
+                const auto distanceVB = DirectX::XMVectorSubtract(DirectX::XMVectorMultiply(dz, ubx), DirectX::XMVectorMultiply(dx, ubz));
+
+                //
+                // Overlap along each axis: sum of projected radii minus distance.
+                //
+                const auto overlapUA = DirectX::XMVectorSubtract(
+                    DirectX::XMVectorAdd(eax, DirectX::XMVectorMultiplyAdd(ebx, c, DirectX::XMVectorMultiply(ebz, s))),
+                    DirectX::XMVectorAbs(distanceUA));
+
+                const auto overlapVA = DirectX::XMVectorSubtract(
+                    DirectX::XMVectorAdd(eaz, DirectX::XMVectorMultiplyAdd(ebx, s, DirectX::XMVectorMultiply(ebz, c))),
+                    DirectX::XMVectorAbs(distanceVA));
+
+                const auto overlapUB = DirectX::XMVectorSubtract(
+                    DirectX::XMVectorAdd(ebx, DirectX::XMVectorMultiplyAdd(eax, c, DirectX::XMVectorMultiply(eaz, s))),
+                    DirectX::XMVectorAbs(distanceUB));
+
+                const auto overlapVB = DirectX::XMVectorSubtract(
+                    DirectX::XMVectorAdd(ebz, DirectX::XMVectorMultiplyAdd(eax, s, DirectX::XMVectorMultiply(eaz, c))),
+                    DirectX::XMVectorAbs(distanceVB));
+
+                //
+                // Axis of least overlap becomes contact normal.
+                //
+                auto depth = overlapUA;
+                auto normalX = uax;
+                auto normalZ = uaz;
+                auto distance = distanceUA;
+
+                auto select = [&](DirectX::FXMVECTOR overlap, DirectX::FXMVECTOR axisX, DirectX::FXMVECTOR axisZ, DirectX::GXMVECTOR axisDistance)
+                {
+                    const auto mask = DirectX::XMVectorLess(overlap, depth);
+
+                    depth = DirectX::XMVectorSelect(depth, overlap, mask);
+                    normalX = DirectX::XMVectorSelect(normalX, axisX, mask);
+                    normalZ = DirectX::XMVectorSelect(normalZ, axisZ, mask);
+                    distance = DirectX::XMVectorSelect(distance, axisDistance, mask);
+                };
+
+                select(overlapVA, DirectX::XMVectorNegate(uaz), uax, distanceVA);
+                select(overlapUB, ubx, ubz, distanceUB);
+                select(overlapVB, DirectX::XMVectorNegate(ubz), ubx, distanceVB);
+
+                //
+                // Flip normals to point from first to second body.
+                //
+                const auto flip = DirectX::XMVectorLess(distance, zero);
+                normalX = DirectX::XMVectorSelect(normalX, DirectX::XMVectorNegate(normalX), flip);
+                normalZ = DirectX::XMVectorSelect(normalZ, DirectX::XMVectorNegate(normalZ), flip);
+
+                DirectX::XMFLOAT4A depths;
+                DirectX::XMFLOAT4A normalsX;
+                DirectX::XMFLOAT4A normalsZ;
+                DirectX::XMStoreFloat4A(&depths, depth);
+                DirectX::XMStoreFloat4A(&normalsX, normalX);
+                DirectX::XMStoreFloat4A(&normalsZ, normalZ);
+
+                const float* depthLanes = &depths.x;
+                const float* normalXLanes = &normalsX.x;
+                const float* normalZLanes = &normalsZ.x;
+
+                for (size_t lane = 0; lane < lanes; ++lane)
+                {
+                    //
+                    // Positive overlap on all axes means that boxes intersect.
+                    //
+                    if (depthLanes[lane] > 0.0F)
+                    {
+                        manifolds.push_back(Manifold{ first[lane], second[lane], normalXLanes[lane], normalZLanes[lane], depthLanes[lane] });
+                    }
+                }
+            }
+        });
+    }
+
+    void PlanarPhysics::ResolveContacts(ComponentStorage& components, std::vector<Contact>& contacts) noexcept
+    {
+        const auto count = m_Candidates.size();
+        const auto chunks = (count + NarrowphaseGrainSize - 1) / NarrowphaseGrainSize;
+
+        m_Touching.clear();
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            for (const auto& manifold : m_ChunkManifolds[chunk])
+            {
+                const auto first = manifold.First;
+                const auto second = manifold.Second;
+                const auto firstIndex = m_Indices[first];
+                const auto secondIndex = m_Indices[second];
+
+                if ((m_ResolveMasks[first] & m_LayerBits[second]) != 0)
+                {
+                    //
+                    // Single Gauss-Seidel pass: separate bodies and remove approaching velocity.
+                    //
+                    const auto firstWeight = m_InverseMass[first];
+                    const auto secondWeight = m_InverseMass[second];
+                    const auto weight = firstWeight + secondWeight;
+
+                    auto& firstPosition = components.Positions[firstIndex];
+                    auto& secondPosition = components.Positions[secondIndex];
+                    auto& firstVelocity = components.Velocities[firstIndex];
+                    auto& secondVelocity = components.Velocities[secondIndex];
+
+                    const auto correction = manifold.Depth / weight;
+
+                    firstPosition.x -= manifold.NormalX * correction * firstWeight;
+                    firstPosition.z -= manifold.NormalZ * correction * firstWeight;
+                    secondPosition.x += manifold.NormalX * correction * secondWeight;
+                    secondPosition.z += manifold.NormalZ * correction * secondWeight;
+
+                    const auto approach = (secondVelocity.x - firstVelocity.x) * manifold.NormalX + (secondVelocity.z - firstVelocity.z) * manifold.NormalZ;
+
+                    if (approach < 0.0F)
+                    {
+                        const auto impulse = -(1.0F + Restitution) * approach / weight;
+
+                        firstVelocity.x -= manifold.NormalX * impulse * firstWeight;
+                        firstVelocity.z -= manifold.NormalZ * impulse * firstWeight;
+                        secondVelocity.x += manifold.NormalX * impulse * secondWeight;
+                        secondVelocity.z += manifold.NormalZ * impulse * secondWeight;
+                    }
+                }
+
+                if ((m_NotifyMasks[first] & m_LayerBits[second]) != 0)
+                {
+                    const auto firstID = components.IDs[firstIndex];
+                    const auto secondID = components.IDs[secondIndex];
+                    const auto key = MakePairKey(firstID, secondID);
+
+                    m_Touching.push_back(key);
+
+                    //
+                    // Report only pairs which weren't touching in previous step.
+                    //
+                    if (!std::binary_search(std::begin(m_PreviousTouching), std::end(m_PreviousTouching), key))
+                    {
+                        contacts.push_back(Contact{ firstID, secondID });
+                    }
+                }
+            }
+        }
+
+        std::sort(std::begin(m_Touching), std::end(m_Touching));
+        std::swap(m_Touching, m_PreviousTouching);
+    }
+}
\ No newline at end of file
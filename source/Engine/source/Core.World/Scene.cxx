@@ -5,134 +5,882 @@
 //
 
 #include <Core.World/Scene.hxx>
+#include <Core.World/Physics.hxx>
+#include <Core.World/GameObjectPool.hxx>
 #include <Core.Diagnostics/Trace.hxx>
+#if !defined(CORE_HEADLESS)
 #include <Core.Rendering/RenderSystem.hxx>
+#endif
+#include <Core/Jobs.hxx>
+#include <algorithm>
+#include <cmath>
 #include <PxActor.h>
+#include <PxActiveTransform.h>
 #include <PxRigidBody.h>
 #include <PxRigidDynamic.h>
 
 
 namespace Core::World
 {
+    namespace
+    {
+        //
+        // Actors carry handle of owning game object, not raw pointer.
+        //
+        void* ToUserData(GameObjectID id) noexcept
+        {
+            return reinterpret_cast<void*>(static_cast<uintptr_t>(id));
+        }
+
+        GameObjectID FromUserData(const void* userData) noexcept
+        {
+            return static_cast<GameObjectID>(reinterpret_cast<uintptr_t>(userData));
+        }
+
+        uint64_t MakeTypePair(GameObjectTypeID first, GameObjectTypeID second) noexcept
+        {
+            return (static_cast<uint64_t>(first) << 32) | second;
+        }
+    }
+
     Scene::Scene(physx::PxPhysics* physics, physx::PxSceneDesc sceneDesc) noexcept
-        : m_Physics{ physics }
-        , m_Scene{ nullptr }
+        : m_Scene{ nullptr }
+        , m_Physics{ physics }
+        , m_Planar{}
+        , m_IsUpdating{ false }
+        , m_Accumulator{ 0.0F }
+        , m_InterpolationAlpha{ 1.0F }
+        , m_MaxSubsteps{ DefaultMaxSubsteps }
+        , m_IsSimulationAsync{ false }
+        , m_IsSimulating{ false }
+    {
+        CreateResources();
+
+        //
+        // Customize scene by setting event callback.
+        //
+        sceneDesc.simulationEventCallback = this;
+
+        //
+        // Create instance.
+        //
+        m_Scene = physics->createScene(sceneDesc);
+
+        CORE_TRACE_MESSAGE(Debug, "[SCENE] Creating scene");
+    }
+
+    Scene::Scene(const DirectX::XMFLOAT3& gravity) noexcept
+        : m_Scene{ nullptr }
+        , m_Physics{ nullptr }
+        , m_Planar{ std::make_unique<PlanarPhysics>(gravity) }
+        , m_IsUpdating{ false }
+        , m_Accumulator{ 0.0F }
+        , m_InterpolationAlpha{ 1.0F }
+        , m_MaxSubsteps{ DefaultMaxSubsteps }
+        , m_IsSimulationAsync{ false }
+        , m_IsSimulating{ false }
+    {
+        CreateResources();
+
+        CORE_TRACE_MESSAGE(Debug, "[SCENE] Creating planar scene");
+    }
+
+    Scene::~Scene() noexcept
+    {
+        if (m_Scene != nullptr)
+        {
+            //
+            // Wait for results and release.
+            //
+            m_Scene->fetchResults(true);
+            m_Scene->release();
+        }
+
+        CORE_TRACE_MESSAGE(Debug, "[SCENE] Destroying scene");
+    }
+
+    void Scene::CreateResources() noexcept
+    {
+        //
+        // One command buffer per job worker.
+        //
+        m_CommandBuffers.resize((std::max)(1U, Jobs::GetWorkerCount()));
+
+#if !defined(CORE_HEADLESS)
+        //
+        // Allocate new camera.
+        //
+        m_Camera = Core::MakeRef<Core::World::Camera>();
+
+        //
+        // And instance buffer, filled on render.
+        //
+        m_InstanceCapacity = InitialInstanceCapacity;
+        m_InstanceBuffer = Core::Rendering::RenderSystem::Current->MakeVertexBuffer(Rendering::BufferDesc{ nullptr, m_InstanceCapacity * sizeof(InstanceData) }, true);
+#endif
+    }
+
+#if !defined(CORE_HEADLESS)
+    void Scene::WriteObjectUniforms(size_t index, const Rendering::CommandListRef& commandList) noexcept
+    {
+        //
+        // Get world transform matrix.
+        //
+        auto world = m_Components.GetInterpolatedTransform(index, m_InterpolationAlpha);
+
+        //
+        // Store it in scene params, directly in uniform ring.
+        //
+        const auto allocation = commandList->AllocateUniforms(sizeof(SceneParams));
+        const auto params = static_cast<SceneParams*>(allocation.Data);
+
+        DirectX::XMStoreFloat4x4A(&params->World, world);
+        DirectX::XMStoreFloat4x4A(&params->InverseWorld, DirectX::XMMatrixTranspose(world));
+
+        m_ObjectUniforms[index] = allocation;
+    }
+
+    void Scene::RenderSingleObject(size_t index, const Rendering::CommandListRef& commandList) noexcept
+    {
+        //
+        // Bind scene object params written before submission.
+        //
+        commandList->BindUniforms(Rendering::ShaderMask::Vertex, 1, m_ObjectUniforms[index]);
+
+        //
+        // Render actual mesh of game object.
+        //
+        m_Components.Objects[index]->OnRender(commandList);
+    }
+
+    void Scene::PrepareRenderQueue() noexcept
+    {
+        //
+        // Objects with mesh and material go through render queue; rest renders on its own.
+        //
+        m_RenderQueue.Clear();
+        m_UnsortedObjects.clear();
+
+        const auto count = m_Components.GetCount();
+        m_ObjectUniforms.resize(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto object = m_Components.Objects[i];
+            const auto material = object->m_Material.Get();
+            const auto mesh = object->m_Mesh.Get();
+
+            if (material != nullptr && mesh != nullptr)
+            {
+                const auto key = Rendering::RenderKey::Make(
+                    Rendering::RenderPass::Opaque,
+                    material->GetPipelineStateSortID(material->IsInstanced()),
+                    material->GetTextureSortID(),
+                    material->GetSortID(),
+                    mesh->GetSortID(),
+                    m_Camera->GetNormalizedDepth(DirectX::XMLoadFloat4A(&m_Components.Positions[i]))
+                );
+
+                m_RenderQueue.Push(key, static_cast<uint32_t>(i));
+            }
+            else
+            {
+                m_UnsortedObjects.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        m_RenderQueue.Sort();
+
+        //
+        // Write world matrices of instanced draws in submission order, so each group of equal
+        // material and mesh is contiguous range of instance buffer.
+        //
+        m_InstanceData.clear();
+
+        for (size_t i = 0; i < m_RenderQueue.GetCount(); ++i)
+        {
+            const auto index = m_RenderQueue[i].Index;
+
+            if (m_Components.Objects[index]->m_Material->IsInstanced())
+            {
+                m_InstanceData.emplace_back();
+                DirectX::XMStoreFloat4x4(&m_InstanceData.back().World, m_Components.GetInterpolatedTransform(index, m_InterpolationAlpha));
+            }
+        }
+    }
+
+    void Scene::UploadInstanceData(const Rendering::CommandListRef& commandList) noexcept
+    {
+        if (m_InstanceData.empty())
+        {
+            return;
+        }
+
+        //
+        // Grow instance buffer geometrically, so it's reallocated only few times.
+        //
+        if (m_InstanceData.size() > m_InstanceCapacity)
+        {
+            while (m_InstanceCapacity < m_InstanceData.size())
+            {
+                m_InstanceCapacity *= 2;
+            }
+
+            m_InstanceBuffer = Core::Rendering::RenderSystem::Current->MakeVertexBuffer(Rendering::BufferDesc{ nullptr, m_InstanceCapacity * sizeof(InstanceData) }, true);
+        }
+
+        commandList->UpdateVertexBuffer(m_InstanceBuffer, m_InstanceData.data(), m_InstanceData.size() * sizeof(InstanceData));
+    }
+
+    void Scene::RenderUnsortedObjects(const Rendering::CommandListRef& commandList) noexcept
+    {
+        for (const auto index : m_UnsortedObjects)
+        {
+            WriteObjectUniforms(index, commandList);
+        }
+
+        for (const auto index : m_UnsortedObjects)
+        {
+            RenderSingleObject(index, commandList);
+        }
+    }
+
+    void Scene::SubmitRenderQueue(const Rendering::CommandListRef& commandList, size_t first, size_t last, uint32_t instance) noexcept
+    {
+        if (first == last)
+        {
+            return;
+        }
+
+        if (!m_InstanceData.empty())
+        {
+            commandList->BindVertexBuffer(1, m_InstanceBuffer, sizeof(InstanceData), 0);
+        }
+
+        //
+        // Params of objects drawn one by one are written before first draw, so all of them fill
+        // uniform ring with single map.
+        //
+        for (auto i = first; i < last; ++i)
+        {
+            const auto index = m_RenderQueue[i].Index;
+
+            if (!m_Components.Objects[index]->m_Material->IsInstanced())
+            {
+                WriteObjectUniforms(index, commandList);
+            }
+        }
+
+        //
+        // Submit in key order. Runs of instanced draws with the same material and mesh are merged
+        // into single draw call; material is rebound only when it changes.
+        //
+        Rendering::MaterialRenderer* boundMaterial = nullptr;
+
+        while (first < last)
+        {
+            const auto object = m_Components.Objects[m_RenderQueue[first].Index];
+            const auto material = object->m_Material.Get();
+            const auto mesh = object->m_Mesh.Get();
+
+            if (!material->IsInstanced())
+            {
+                RenderSingleObject(m_RenderQueue[first].Index, commandList);
+
+                //
+                // Object binds its material on its own.
+                //
+                boundMaterial = nullptr;
+                ++first;
+                continue;
+            }
+
+            auto end = first + 1;
+
+            while (end < last)
+            {
+                const auto next = m_Components.Objects[m_RenderQueue[end].Index];
+
+                if (next->m_Material.Get() != material || next->m_Mesh.Get() != mesh)
+                {
+                    break;
+                }
+
+                ++end;
+            }
+
+            if (material != boundMaterial)
+            {
+                boundMaterial = material;
+                material->BindInstanced(commandList);
+            }
+
+            const auto instanceCount = static_cast<uint32_t>(end - first);
+
+            mesh->Bind(commandList);
+            mesh->RenderInstanced(commandList, instanceCount, instance);
+
+            instance += instanceCount;
+            first = end;
+        }
+    }
+#endif
+
+    void Scene::OnUpdate(float deltaTime) noexcept
+    {
+        //
+        // Run per type kernels over component storage.
+        //
+        for (auto& kernel : m_UpdateKernels)
+        {
+            kernel.second(m_Components, kernel.first, deltaTime);
+        }
+
+        //
+        // Only objects which really need it are updated through virtual call. Objects are updated
+        // in parallel; any spawn or destroy request is recorded to command buffer of current worker.
+        //
+        m_IsUpdating = true;
+
+        Jobs::ParallelFor(m_Components.GetCount(), UpdateGrainSize, [&](size_t begin, size_t end)
+        {
+            auto& buffer = m_CommandBuffers[Jobs::GetCurrentWorkerIndex()];
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                if ((m_Components.Flags[i] & ComponentFlags::Update) == ComponentFlags::Update)
+                {
+                    buffer.CurrentObject = i;
+                    buffer.Sequence = 0;
+
+                    m_Components.Objects[i]->OnUpdate(deltaTime);
+                }
+            }
+        });
+
+        m_IsUpdating = false;
+
+        //
+        // Sync point: apply structural changes before physics step.
+        //
+        ApplyDeferredCommands();
+    }
+
+    void Scene::DeferDestroy(GameObject* gameObject) noexcept
+    {
+        PushCommand(gameObject, false);
+    }
+
+    void Scene::PushCommand(GameObject* gameObject, bool isSpawn) noexcept
+    {
+        auto& buffer = m_CommandBuffers[Jobs::GetCurrentWorkerIndex()];
+
+        const auto order = (buffer.CurrentObject << 32) | buffer.Sequence++;
+
+        buffer.Commands.push_back(DeferredCommand{ order, GameObjectRef{ gameObject }, isSpawn });
+    }
+
+    void Scene::ApplyDeferredCommands() noexcept
+    {
+        //
+        // Gather commands from all workers.
+        //
+        for (auto& buffer : m_CommandBuffers)
+        {
+            for (auto& command : buffer.Commands)
+            {
+                m_PendingCommands.push_back(std::move(command));
+            }
+
+            buffer.Commands.clear();
+        }
+
+        //
+        // Order doesn't depend on which worker processed which object.
+        //
+        std::sort(std::begin(m_PendingCommands), std::end(m_PendingCommands), [](const DeferredCommand& lhs, const DeferredCommand& rhs)
+        {
+            return lhs.Order < rhs.Order;
+        });
+
+        for (auto& command : m_PendingCommands)
+        {
+            if (command.IsSpawn)
+            {
+                Add(command.Object);
+            }
+            else
+            {
+                command.Object->Destroy();
+            }
+        }
+
+        m_PendingCommands.clear();
+    }
+
+    void Scene::ExpireObjects() noexcept
+    {
+        m_Expiry.Advance(m_Expired);
+
+        for (const auto& timer : m_Expired)
+        {
+            //
+            // Objects removed before their time resolve to nothing. Full generation check rejects
+            // objects which got the same handle after its generation wrapped.
+            //
+            if (auto gameObject = Resolve(timer.Object))
+            {
+                if (m_Handles.GetFullGeneration(timer.Object) == timer.Generation)
+                {
+                    gameObject->Destroy();
+                }
+            }
+        }
+
+        m_Expired.clear();
+    }
+
+    void Scene::RegisterUpdateKernel(GameObjectTypeID typeID, UpdateKernel kernel) noexcept
+    {
+        CORE_ASSERT(kernel != nullptr);
+
+        m_UpdateKernels.emplace_back(typeID, kernel);
+    }
+
+    void Scene::RegisterContactHandler(GameObjectTypeID first, GameObjectTypeID second, ContactHandler handler) noexcept
+    {
+        CORE_ASSERT(handler != nullptr);
+
+        //
+        // Type pairs are stored with lower type first.
+        //
+        const auto isSwapped = first > second;
+        const auto typePair = isSwapped ? MakeTypePair(second, first) : MakeTypePair(first, second);
+
+        auto it = std::lower_bound(std::begin(m_ContactHandlers), std::end(m_ContactHandlers), typePair, [](const ContactHandlerEntry& entry, uint64_t value)
+        {
+            return entry.TypePair < value;
+        });
+
+        CORE_ASSERT(it == std::end(m_ContactHandlers) || it->TypePair != typePair);
+
+        m_ContactHandlers.insert(it, ContactHandlerEntry{ typePair, handler, isSwapped });
+    }
+
+    void Scene::SyncToPhysics() noexcept
+    {
+        const auto count = m_Components.GetCount();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto rigid = m_Components.RigidBodies[i];
+
+            if (rigid == nullptr)
+            {
+                continue;
+            }
+
+            const auto flags = m_Components.Flags[i];
+
+            if ((flags & ComponentFlags::DrivenVelocity) == ComponentFlags::DrivenVelocity)
+            {
+                //
+                // Velocity is owned by component storage.
+                //
+                rigid->setLinearVelocity(Converters::XMVECTORToPxVec3(DirectX::XMLoadFloat4A(&m_Components.Velocities[i])));
+            }
+
+            if ((flags & ComponentFlags::Kinematic) == ComponentFlags::Kinematic)
+            {
+                //
+                // Kinematic bodies are moved by game logic.
+                //
+                const physx::PxTransform target{
+                    Converters::XMVECTORToPxVec3(DirectX::XMLoadFloat4A(&m_Components.KinematicTargets[i])),
+                    Converters::XMVECTORToPxQuat(DirectX::XMLoadFloat4A(&m_Components.Orientations[i]))
+                };
+
+                rigid->setKinematicTarget(target);
+            }
+        }
+    }
+
+    void Scene::SyncFromPhysics() noexcept
+    {
+        //
+        // Only actors which moved during last step are reported. Sleeping and static actors keep
+        // their cached transforms and cost nothing here.
+        //
+        physx::PxU32 count{};
+        auto transforms = m_Scene->getActiveTransforms(count);
+
+        for (physx::PxU32 i = 0; i < count; ++i)
+        {
+            const auto& active = transforms[i];
+
+            //
+            // Actor user data is copied to active transform, so transform is read without touching
+            // actor.
+            //
+            const auto index = m_Handles.Resolve(FromUserData(active.userData));
+
+            if (index == HandleTable::InvalidIndex)
+            {
+                continue;
+            }
+
+            DirectX::XMStoreFloat4A(&m_Components.Positions[index], Converters::PxVec3ToXMVECTOR(active.actor2World.p));
+            DirectX::XMStoreFloat4A(&m_Components.Orientations[index], Converters::PxQuatToXMVECTOR(active.actor2World.q));
+
+            //
+            // Velocity isn't part of active transform. Component storage owns velocity of driven
+            // bodies, so actor is queried only for the rest.
+            //
+            if ((m_Components.Flags[index] & ComponentFlags::DrivenVelocity) != ComponentFlags::DrivenVelocity)
+            {
+                DirectX::XMStoreFloat4A(&m_Components.Velocities[index], Converters::PxVec3ToXMVECTOR(m_Components.RigidBodies[index]->getLinearVelocity()));
+            }
+        }
+    }
+
+    void Scene::DispatchContacts() noexcept
+    {
+        if (m_Contacts.empty())
+        {
+            return;
+        }
+
+        //
+        // Resolve types and drop contacts with objects which are already gone. Each pair is stored
+        // in canonical order, so duplicates end up next to each other after sort.
+        //
+        size_t count = 0;
+
+        for (auto contact : m_Contacts)
+        {
+            const auto first = m_Handles.Resolve(contact.First);
+            const auto second = m_Handles.Resolve(contact.Second);
+
+            if (first == HandleTable::InvalidIndex || second == HandleTable::InvalidIndex)
+            {
+                continue;
+            }
+
+            auto firstType = m_Components.Types[first];
+            auto secondType = m_Components.Types[second];
+
+            if (firstType > secondType || (firstType == secondType && contact.First > contact.Second))
+            {
+                std::swap(firstType, secondType);
+                std::swap(contact.First, contact.Second);
+            }
+
+            contact.TypePair = MakeTypePair(firstType, secondType);
+            m_Contacts[count++] = contact;
+        }
+
+        m_Contacts.resize(count);
+
+        std::sort(std::begin(m_Contacts), std::end(m_Contacts), [](const ContactEvent& lhs, const ContactEvent& rhs)
+        {
+            if (lhs.TypePair != rhs.TypePair)
+            {
+                return lhs.TypePair < rhs.TypePair;
+            }
+
+            if (lhs.First != rhs.First)
+            {
+                return lhs.First < rhs.First;
+            }
+
+            return lhs.Second < rhs.Second;
+        });
+
+        auto last = std::unique(std::begin(m_Contacts), std::end(m_Contacts), [](const ContactEvent& lhs, const ContactEvent& rhs)
+        {
+            return lhs.First == rhs.First && lhs.Second == rhs.Second;
+        });
+
+        m_Contacts.erase(last, std::end(m_Contacts));
+
+        //
+        // Both sequences are sorted by type pair, so handler lookup is single forward walk.
+        //
+        auto handler = std::begin(m_ContactHandlers);
+
+        for (const auto& contact : m_Contacts)
+        {
+            while (handler != std::end(m_ContactHandlers) && handler->TypePair < contact.TypePair)
+            {
+                ++handler;
+            }
+
+            //
+            // Destroyed objects keep their handles until pending objects are removed.
+            //
+            auto first = Resolve(contact.First);
+            auto second = Resolve(contact.Second);
+
+            if (handler != std::end(m_ContactHandlers) && handler->TypePair == contact.TypePair)
+            {
+                if (handler->IsSwapped)
+                {
+                    handler->Handler(second, first);
+                }
+                else
+                {
+                    handler->Handler(first, second);
+                }
+            }
+            else
+            {
+                first->OnCollision(second);
+                second->OnCollision(first);
+            }
+        }
+
+        m_Contacts.clear();
+    }
+
+#if !defined(CORE_HEADLESS)
+    void Scene::OnRender(const Rendering::CommandListRef& commandList) noexcept
+    {
+        PrepareRenderQueue();
+        UploadInstanceData(commandList);
+
+        //
+        // Bind any camera resources.
+        //
+        m_Camera->Bind(commandList);
+
+        RenderUnsortedObjects(commandList);
+        SubmitRenderQueue(commandList, 0, m_RenderQueue.GetCount(), 0);
+    }
+
+    void Scene::OnRender(const Rendering::CommandListRef& commandList, const Rendering::ViewportRef& viewport) noexcept
     {
+        const auto batchCount = (std::min)(static_cast<size_t>(Jobs::GetWorkerCount()), m_Components.GetCount() / MinRenderBatchSize);
+
+        if (batchCount <= 1)
+        {
+            OnRender(commandList);
+            return;
+        }
+
+        PrepareRenderQueue();
+        UploadInstanceData(commandList);
+
         //
-        // Allocate new camera.
+        // Split sorted queue into equal contiguous ranges. Pool of command lists may grow here, so
+        // lists are acquired before recording starts.
         //
-        m_Camera = Core::MakeRef<Core::World::Camera>();
+        const auto count = m_RenderQueue.GetCount();
+        auto renderSystem = Rendering::RenderSystem::Current;
+
+        m_RenderBatches.resize(batchCount);
+
+        for (size_t i = 0; i < batchCount; ++i)
+        {
+            auto& batch = m_RenderBatches[i];
+            batch.First = (count * i) / batchCount;
+            batch.Last = (count * (i + 1)) / batchCount;
+            batch.Instance = 0;
+            batch.CommandList = renderSystem->GetDeferredCommandList(i);
+        }
 
         //
-        // Allocate uniform buffer for scene data.
+        // Each batch starts at instance following all instanced draws of previous batches.
         //
-        m_CurrentObject = Core::Rendering::RenderSystem::Current->MakeUniformBuffer(Rendering::BufferDesc{ m_SceneParams });
+        uint32_t instance = 0;
+        size_t current = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            while (current < batchCount && m_RenderBatches[current].First == i)
+            {
+                m_RenderBatches[current++].Instance = instance;
+            }
+
+            if (m_Components.Objects[m_RenderQueue[i].Index]->m_Material->IsInstanced())
+            {
+                ++instance;
+            }
+        }
 
         //
-        // Customize scene by setting event callback.
+        // Record batches in parallel. Deferred context starts with cleared state, so each list sets
+        // up render targets and camera on its own.
         //
-        sceneDesc.simulationEventCallback = this;
+        Jobs::ParallelFor(batchCount, 1, [&](size_t begin, size_t end)
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto& batch = m_RenderBatches[i];
+                const auto& list = batch.CommandList;
+
+                list->BindViewport(viewport);
+                m_Camera->Bind(list);
+
+                if (i == 0)
+                {
+                    RenderUnsortedObjects(list);
+                }
+
+                SubmitRenderQueue(list, batch.First, batch.Last, batch.Instance);
+                list->Finish();
+            }
+        });
 
         //
-        // Create instance.
+        // Execute in batch order, so result doesn't depend on which worker finished first.
         //
-        m_Scene = physics->createScene(sceneDesc);
-
-        CORE_TRACE_MESSAGE(Debug, "[SCENE] Creating scene");
+        for (const auto& batch : m_RenderBatches)
+        {
+            renderSystem->Execute(batch.CommandList);
+        }
     }
+#endif
 
-    Scene::~Scene() noexcept
+    void Scene::Add(const GameObjectRef& gameObject) noexcept
     {
         //
-        // Wait for results and release.
+        // Sanity check.
         //
-        m_Scene->fetchResults(true);
-        m_Scene->release();
-
-        CORE_TRACE_MESSAGE(Debug, "[SCENE] Destroying scene");
-    }
+        CORE_ASSERT(gameObject != nullptr);
 
-    void Scene::RenderSingleObject(const World::GameObjectRef& gameObject, const Rendering::CommandListRef& commandList) noexcept
-    {
         //
-        // Get world transform matrix.
+        // Check if object isn't on any scene already.
         //
-        auto world = gameObject->GetTransform();
+        CORE_ASSERT(gameObject->m_Scene == nullptr);
+
+        if (m_IsUpdating)
+        {
+            //
+            // Can't change scene structure while objects are updated.
+            //
+            PushCommand(gameObject.Get(), true);
+            return;
+        }
 
         //
-        // Store it in scene params.
+        // Actor can't be added while simulation is running.
         //
-        DirectX::XMStoreFloat4x4A(&m_SceneParams.World, world);
-        DirectX::XMStoreFloat4x4A(&m_SceneParams.InverseWorld, DirectX::XMMatrixTranspose(world));
+        FetchResults();
 
         //
-        // Update GPU buffer with scene object params.
+        // Fine, push it back to list.
         //
-        commandList->UpdateUniformBuffer(m_CurrentObject, &m_SceneParams, sizeof(m_SceneParams));
+        m_Objects.push_back(gameObject);
 
         //
-        // Render actual mesh of game object.
+        // Allocate components slot with initial object values.
         //
-        gameObject->OnRender(commandList);
-    }
+        const auto& body = gameObject->m_Body;
+        auto index = m_Components.Push(gameObject.Get(), nullptr, gameObject->TypeID);
+
+        m_Components.Flags[index] = gameObject->m_ComponentFlags;
+        m_Components.Scales[index] = gameObject->m_Scale;
+        m_Components.Positions[index] = body.Position;
+        m_Components.Orientations[index] = body.Orientation;
+        m_Components.Velocities[index] = body.Velocity;
+        m_Components.AngularVelocities[index] = body.AngularVelocity;
 
-    void Scene::OnUpdate(float deltaTime) noexcept
-    {
         //
-        // Update all game objects.
+        // Hand out stable handle.
         //
-        for (auto& gameObject : m_Objects)
-        {
-            gameObject->OnUpdate(deltaTime);
-        }
-    }
+        const auto id = m_Handles.Allocate(static_cast<uint32_t>(index));
+        m_Components.IDs[index] = id;
+
+        gameObject->m_Scene = this;
+        gameObject->m_ID = id;
 
-    void Scene::OnRender(const Rendering::CommandListRef& commandList) noexcept
-    {
         //
-        // Bind uniform buffer with object data.
+        // Bounds and layer are used by spatial queries even without rigid body.
         //
-        commandList->BindUniformBuffer(Core::Rendering::ShaderMask::Vertex, 1, m_CurrentObject);
+        m_Components.Extents[index] = body.Extent;
+        m_Components.Layers[index] = body.Layer;
+
+        if (body.IsEnabled)
+        {
+            m_Components.Flags[index] |= ComponentFlags::RigidBody;
+
+            if (m_Scene != nullptr)
+            {
+                //
+                // Planar backend simulates bodies right in component storage.
+                //
+                AddRigidBody(gameObject.Get(), index);
+            }
+        }
 
         //
-        // Bind any camera resources.
+        // New object has no history to interpolate from.
         //
-        m_Camera->Bind(commandList);
+        m_Components.PreviousPositions[index] = m_Components.Positions[index];
+        m_Components.PreviousOrientations[index] = m_Components.Orientations[index];
+        m_Components.KinematicTargets[index] = m_Components.Positions[index];
+        m_Components.PlaneHeights[index] = m_Components.Positions[index].y;
 
         //
-        // Apply rendering to all objects on scene.
+        // Zero time to live means that object lives forever.
         //
-        for (auto& gameObject : m_Objects)
+        if (gameObject->m_TimeToLive > 0.0F)
         {
-            RenderSingleObject(gameObject, commandList);
+            m_Expiry.Schedule(id, m_Handles.GetFullGeneration(id), static_cast<uint64_t>(std::ceil(gameObject->m_TimeToLive / FixedDeltaTime)));
         }
     }
 
-    void Scene::Add(const GameObjectRef& gameObject) noexcept
+    void Scene::AddRigidBody(GameObject* gameObject, size_t index) noexcept
     {
-        //
-        // Sanity check.
-        //
-        CORE_ASSERT(gameObject != nullptr);
+        const auto& body = gameObject->m_Body;
+        const auto isKinematic = (gameObject->m_ComponentFlags & ComponentFlags::Kinematic) == ComponentFlags::Kinematic;
 
-        //
-        // Check if object isn't at list already.
-        //
-        CORE_ASSERT(std::find(std::begin(m_Objects), std::end(m_Objects), gameObject) == std::end(m_Objects));
+        auto rigid = gameObject->m_RigidBody;
 
-        //
-        // Fine, push it back to list.
-        //
-        m_Objects.push_back(gameObject);
+        if (rigid == nullptr)
+        {
+            //
+            // Actor is created on first use and stays with object afterwards.
+            //
+            rigid = Physics::MakeRigidBody();
+            rigid->setLinearDamping(0.0F);
+            rigid->setAngularDamping(0.0F);
+
+            gameObject->m_RigidBody = rigid;
+        }
 
         //
-        // Add actor to physx scene.
+        // Shapes are shared, so swap to shape matching current extent.
         //
-        auto rigid = gameObject->m_RigidBody;
-        if (rigid != nullptr)
+        auto shape = Physics::MakeBoxCollider(DirectX::XMLoadFloat4A(&body.Extent), body.Layer);
+
+        if (shape != gameObject->m_Shape)
+        {
+            if (gameObject->m_Shape != nullptr)
+            {
+                rigid->detachShape(*gameObject->m_Shape);
+            }
+
+            rigid->attachShape(*shape);
+            gameObject->m_Shape = shape;
+        }
+
+        rigid->setRigidDynamicFlag(physx::PxRigidBodyFlag::eKINEMATIC, isKinematic);
+        rigid->setGlobalPose(physx::PxTransform{
+            Converters::XMVECTORToPxVec3(DirectX::XMLoadFloat4A(&body.Position)),
+            Converters::XMVECTORToPxQuat(DirectX::XMLoadFloat4A(&body.Orientation))
+        });
+
+        if (!isKinematic)
         {
-            m_Scene->addActor(*rigid);
+            rigid->setLinearVelocity(Converters::XMVECTORToPxVec3(DirectX::XMLoadFloat4A(&body.Velocity)));
+            rigid->setAngularVelocity(Converters::XMVECTORToPxVec3(DirectX::XMLoadFloat4A(&body.AngularVelocity)));
         }
+
+        rigid->userData = ToUserData(m_Components.IDs[index]);
+        m_Components.RigidBodies[index] = rigid;
+
+        m_Scene->addActor(*rigid);
     }
 
     void Scene::Remove(const GameObjectRef& gameObject) noexcept
@@ -145,7 +893,8 @@ namespace Core::World
         //
         // Make sure that object is on scene.
         //
-        CORE_ASSERT(std::find(std::begin(m_Objects), std::end(m_Objects), gameObject) != std::end(m_Objects));
+        CORE_ASSERT(gameObject->m_Scene == this);
+        CORE_ASSERT(m_Handles.IsValid(gameObject->m_ID));
 
         //
         // Just mark object to be removed.
@@ -156,61 +905,332 @@ namespace Core::World
     void Scene::Tick(float deltaTime) noexcept
     {
         //
-        // Update physics with fixed delta time step.
+        // Complete step left running by previous tick.
+        //
+        FetchResults();
+
+        //
+        // Accumulate frame time and consume it in fixed steps.
+        //
+        m_Accumulator += deltaTime;
+
+        auto steps = static_cast<uint32_t>(m_Accumulator / FixedDeltaTime);
+
+        if (steps > m_MaxSubsteps)
+        {
+            //
+            // Can't keep up with real time; drop excess.
+            //
+            steps = m_MaxSubsteps;
+            m_Accumulator = static_cast<float>(steps) * FixedDeltaTime + std::fmod(m_Accumulator, FixedDeltaTime);
+        }
+
+        for (uint32_t i = 0; i < steps; ++i)
+        {
+            if (i + 1 == steps)
+            {
+                if (m_IsSimulationAsync)
+                {
+                    //
+                    // Leave last step running; it is fetched on next frame.
+                    //
+                    BeginStep();
+                }
+                else
+                {
+                    //
+                    // Only state before last step is needed for interpolation.
+                    //
+                    m_Components.StorePreviousTransforms();
+                    Step();
+                }
+            }
+            else
+            {
+                if (m_IsSimulationAsync && i + 2 == steps)
+                {
+                    //
+                    // Last step is left running, so rendered state is result of this one; keep
+                    // interpolation range at single step.
+                    //
+                    m_Components.StorePreviousTransforms();
+                }
+
+                Step();
+            }
+
+            m_Accumulator -= FixedDeltaTime;
+        }
+
+        //
+        // Render between last two simulated states.
         //
-        auto delta = deltaTime;
-        while (delta >= 0.0F)
+        m_InterpolationAlpha = Clamp(m_Accumulator / FixedDeltaTime, 0.0F, 1.0F);
+    }
+
+    void Scene::FetchResults() noexcept
+    {
+        if (m_IsSimulating)
+        {
+            //
+            // State before this step is used for interpolation.
+            //
+            m_Components.StorePreviousTransforms();
+            EndStep();
+        }
+    }
+
+    void Scene::SetAsyncSimulation(bool value) noexcept
+    {
+        FetchResults();
+        m_IsSimulationAsync = value;
+    }
+
+    void Scene::Step() noexcept
+    {
+        BeginStep();
+        EndStep();
+    }
+
+    void Scene::BeginStep() noexcept
+    {
+        CORE_ASSERT(!m_IsSimulating);
+
+        if (m_Scene != nullptr)
         {
             //
-            // Simulate & fetch at fixed elta time.
+            // Push component driven state to physics.
+            //
+            SyncToPhysics();
+
+            //
+            // Simulate at fixed delta time.
             //
             m_Scene->simulate(FixedDeltaTime);
+        }
+
+        //
+        // Planar step runs when results are fetched, so state before it is still available
+        // for interpolation.
+        //
+        m_IsSimulating = true;
+    }
+
+    void Scene::EndStep() noexcept
+    {
+        CORE_ASSERT(m_IsSimulating);
+
+        if (m_Scene != nullptr)
+        {
+            //
+            // Wait for results. Contact callbacks are dispatched from here.
+            //
             m_Scene->fetchResults(true);
 
             //
-            // Try to remove pending objects.
+            // And read simulation results back.
+            //
+            SyncFromPhysics();
+
+            //
+            // Pull planar bodies back to their planes.
             //
-            RemovePendingObjects();
+            Physics::ApplyPlanarConstraints(m_Components);
+        }
+        else
+        {
+            m_Planar->Simulate(m_Components, FixedDeltaTime, m_PlanarContacts);
+
+            for (const auto& contact : m_PlanarContacts)
+            {
+                m_Contacts.push_back(ContactEvent{ 0, contact.First, contact.Second });
+            }
+
+            m_PlanarContacts.clear();
+        }
+
+        m_IsSimulating = false;
+
+        //
+        // Index state after step and trace projectiles through it.
+        //
+        m_SpatialGrid.Build(m_Components);
+        AdvanceProjectiles();
+
+        //
+        // Objects expiring in this step are removed together with ones destroyed by contacts.
+        //
+        ExpireObjects();
+
+        //
+        // Run gameplay collision handling outside of physics callbacks.
+        //
+        DispatchContacts();
+
+        //
+        // Try to remove pending objects.
+        //
+        RemovePendingObjects();
+    }
+
+    void Scene::AdvanceProjectiles() noexcept
+    {
+        m_ProjectileIndices.clear();
+        m_ProjectileRays.clear();
+
+        const auto count = m_Components.GetCount();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if ((m_Components.Flags[i] & ComponentFlags::Projectile) != ComponentFlags::Projectile)
+            {
+                continue;
+            }
+
+            const auto& position = m_Components.Positions[i];
+            const auto& velocity = m_Components.Velocities[i];
+            const auto layer = m_Components.Layers[i];
 
             //
-            // Update counter.
+            // Grid is planar, so only horizontal part of path is traced.
             //
-            delta -= FixedDeltaTime;
+            const auto speed = std::sqrt(velocity.x * velocity.x + velocity.z * velocity.z);
+
+            m_ProjectileIndices.push_back(static_cast<uint32_t>(i));
+            m_ProjectileRays.push_back(RayQuery{
+                DirectX::XMFLOAT3{ position.x, position.y, position.z },
+                DirectX::XMFLOAT3{ velocity.x, velocity.y, velocity.z },
+                speed * FixedDeltaTime,
+                Physics::GetCollisionMask(layer, CollisionResponse::Notify) & ~(1U << layer)
+            });
+        }
+
+        if (m_ProjectileRays.empty())
+        {
+            return;
+        }
+
+        m_ProjectileHits.resize(m_ProjectileRays.size());
+        m_SpatialGrid.CastRays(m_ProjectileRays.data(), m_ProjectileRays.size(), m_ProjectileHits.data());
+
+        const auto step = DirectX::XMVectorReplicate(FixedDeltaTime);
+
+        for (size_t i = 0; i < m_ProjectileIndices.size(); ++i)
+        {
+            const auto index = m_ProjectileIndices[i];
+            const auto& hit = m_ProjectileHits[i];
+
+            if (hit.Object != InvalidGameObjectID)
+            {
+                m_Contacts.push_back(ContactEvent{ 0, m_Components.IDs[index], hit.Object });
+            }
+
+            const auto position = DirectX::XMLoadFloat4A(&m_Components.Positions[index]);
+            const auto velocity = DirectX::XMLoadFloat4A(&m_Components.Velocities[index]);
+
+            DirectX::XMStoreFloat4A(&m_Components.Positions[index], DirectX::XMVectorMultiplyAdd(velocity, step, position));
         }
     }
 
     void Scene::RemovePendingObjects() noexcept
     {
-        //
-        // Capture range.
-        //
-        auto begin = std::begin(m_Objects);
-        auto end = std::end(m_Objects);
+        if (m_PendingRemovals.empty())
+        {
+            return;
+        }
+
+        if (m_Scene != nullptr)
+        {
+            //
+            // Take actors out of physics scene in single batch, while objects still hold them.
+            //
+            for (const auto id : m_PendingRemovals)
+            {
+                const auto index = m_Handles.Resolve(id);
+
+                if (index != HandleTable::InvalidIndex && m_Components.RigidBodies[index] != nullptr)
+                {
+                    m_RemovedActors.push_back(m_Components.RigidBodies[index]);
+                }
+            }
+
+            if (!m_RemovedActors.empty())
+            {
+                m_Scene->removeActors(m_RemovedActors.data(), static_cast<physx::PxU32>(m_RemovedActors.size()));
+                m_RemovedActors.clear();
+            }
+        }
 
         //
-        // Remove and compact items on scene.
+        // Swap and pop each removed object. Indices move while removing, so handles are resolved
+        // again.
         //
-        auto it = std::remove_if(begin, end, [&](auto o) -> bool
+        for (const auto id : m_PendingRemovals)
         {
-            if (o->IsMarkedToRemove())
+            const auto index = m_Handles.Resolve(id);
+
+            if (index != HandleTable::InvalidIndex)
             {
-                //
-                // Notify that object will be remove.
-                //
-                o->OnRemoveFromScene(m_Scene);
-                return true;
+                RemoveAt(index);
             }
-            return false;
-        });
+        }
+
+        m_PendingRemovals.clear();
+    }
+
+    void Scene::RemoveAt(size_t index) noexcept
+    {
+        auto object = m_Objects[index];
+
+        //
+        // Notify that object will be remove.
+        //
+        object->OnRemoveFromScene(m_Scene);
+
+        if (m_Components.RigidBodies[index] != nullptr)
+        {
+            m_Components.RigidBodies[index]->userData = ToUserData(InvalidGameObjectID);
+        }
+
+        //
+        // Invalidate handle.
+        //
+        m_Handles.Release(object->m_ID);
+        object->m_Scene = nullptr;
+        object->m_ID = InvalidGameObjectID;
+        object->m_MarkedToRemove = false;
+
+        //
+        // Pooled objects are parked for reuse instead of being released.
+        //
+        if (object->m_Pool != nullptr)
+        {
+            object->m_Pool->Release(object.Get());
+        }
 
         //
-        // Erase removed items slots.
+        // Swap last object into freed slot and pop.
         //
-        m_Objects.erase(it, end);
+        const auto last = m_Components.GetCount() - 1;
+
+        if (index != last)
+        {
+            m_Objects[index] = std::move(m_Objects[last]);
+            m_Components.Move(index, last);
+            m_Handles.Update(m_Components.IDs[index], static_cast<uint32_t>(index));
+        }
+
+        m_Objects.pop_back();
+        m_Components.Resize(last);
     }
 
     void Scene::Clear() noexcept
     {
+        //
+        // Actors can't be removed while simulation is running.
+        //
+        FetchResults();
+
         //
         // Destroy all objects in scene.
         //
@@ -225,6 +1245,13 @@ namespace Core::World
         // Previous step will just mark objects as destroyed.
         //
         RemovePendingObjects();
+
+        //
+        // Every slot is free now; rebuild free list so new scene reuses slots from first one.
+        //
+        m_Handles.Clear();
+        m_SpatialGrid.Clear();
+        m_Expiry.Clear();
     }
 
     void Scene::onConstraintBreak(physx::PxConstraintInfo* constraints, physx::PxU32 count)
@@ -256,22 +1283,13 @@ namespace Core::World
         if (!pairHeader.flags.isSet(physx::PxContactPairHeaderFlag::eREMOVED_ACTOR_0))
         {
             //
-            // Extract game objects from contact header.
-            //
-            auto go1 = reinterpret_cast<World::GameObject*>(pairHeader.actors[0]->userData);
-            auto go2 = reinterpret_cast<World::GameObject*>(pairHeader.actors[1]->userData);
-
-            //
-            // All objects on scene must have user data set.
-            //
-            CORE_ASSERT(go1 != nullptr);
-            CORE_ASSERT(go2 != nullptr);
-
-            //
-            // Notify them about collision.
+            // Just record handles stored in actors; contacts are dispatched after fetch completes.
             //
-            go1->OnCollision(go2);
-            go2->OnCollision(go1);
+            m_Contacts.push_back(ContactEvent{
+                0,
+                FromUserData(pairHeader.actors[0]->userData),
+                FromUserData(pairHeader.actors[1]->userData)
+            });
         }
     }
 
@@ -0,0 +1,455 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core.World/SpatialGrid.hxx>
+#include <Core.Diagnostics/Debug.hxx>
+#include <Core/Jobs.hxx>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Core::World
+{
+    namespace
+    {
+        //
+        // Cell coordinates are clamped, so far away or non-finite positions still map to valid cell.
+        //
+        constexpr const float CellLimit = static_cast<float>(1 << 30);
+
+        uint64_t MakeCellKey(int32_t x, int32_t z) noexcept
+        {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+        }
+    }
+
+    SpatialGrid::SpatialGrid() noexcept
+        : m_CellSize{ DefaultCellSize }
+        , m_InverseCellSize{ 1.0F / DefaultCellSize }
+        , m_BucketShift{ 64 - MinBucketBits }
+    {
+        Clear();
+    }
+
+    void SpatialGrid::SetCellSize(float value) noexcept
+    {
+        CORE_ASSERT(value > 0.0F);
+
+        m_CellSize = value;
+        m_InverseCellSize = 1.0F / value;
+    }
+
+    void SpatialGrid::Clear() noexcept
+    {
+        m_IDs.clear();
+        m_CenterX.clear();
+        m_CenterZ.clear();
+        m_Radius.clear();
+        m_LayerBits.clear();
+        m_Cells.clear();
+        m_EntryObjects.clear();
+        m_EntryCells.clear();
+
+        m_BucketShift = 64 - MinBucketBits;
+        m_BucketStart.assign((size_t{ 1 } << MinBucketBits) + 1, 0);
+    }
+
+    void SpatialGrid::Build(const ComponentStorage& components) noexcept
+    {
+        const auto count = components.GetCount();
+
+        m_IDs.resize(count);
+        m_CenterX.resize(count);
+        m_CenterZ.resize(count);
+        m_Radius.resize(count);
+        m_LayerBits.resize(count);
+        m_Cells.resize(count);
+        m_EntryOffsets.resize(count + 1);
+        m_EntryOffsets[0] = 0;
+
+        Jobs::ParallelFor(count, BuildGrainSize, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto& position = components.Positions[i];
+                const auto& extent = components.Extents[i];
+                const auto radius = std::sqrt(extent.x * extent.x + extent.z * extent.z);
+
+                m_IDs[i] = components.IDs[i];
+                m_CenterX[i] = position.x;
+                m_CenterZ[i] = position.z;
+                m_Radius[i] = radius;
+                m_LayerBits[i] = 1U << components.Layers[i];
+
+                const auto range = GetCellRange(position.x - radius, position.z - radius, position.x + radius, position.z + radius);
+                m_Cells[i] = range;
+                m_EntryOffsets[i + 1] = static_cast<uint32_t>(range.MaxX - range.MinX + 1) * static_cast<uint32_t>(range.MaxZ - range.MinZ + 1);
+            }
+        });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_EntryOffsets[i + 1] += m_EntryOffsets[i];
+        }
+
+        const auto entries = static_cast<size_t>(m_EntryOffsets[count]);
+
+        //
+        // Keep buckets at most half full.
+        //
+        auto bucketBits = MinBucketBits;
+
+        while ((size_t{ 1 } << bucketBits) < entries * 2 && bucketBits < MaxBucketBits)
+        {
+            ++bucketBits;
+        }
+
+        m_BucketShift = 64 - bucketBits;
+
+        //
+        // Emit entry for each cell overlapped by object.
+        //
+        m_UnsortedObjects.resize(entries);
+        m_UnsortedCells.resize(entries);
+
+        Jobs::ParallelFor(count, BuildGrainSize, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto& range = m_Cells[i];
+                auto entry = m_EntryOffsets[i];
+
+                for (auto z = range.MinZ; z <= range.MaxZ; ++z)
+                {
+                    for (auto x = range.MinX; x <= range.MaxX; ++x)
+                    {
+                        m_UnsortedObjects[entry] = static_cast<uint32_t>(i);
+                        m_UnsortedCells[entry] = MakeCellKey(x, z);
+                        ++entry;
+                    }
+                }
+            }
+        });
+
+        //
+        // Counting sort by bucket. Stable, so entries of bucket keep object order.
+        //
+        const auto buckets = size_t{ 1 } << bucketBits;
+        m_BucketStart.assign(buckets + 1, 0);
+
+        for (const auto cell : m_UnsortedCells)
+        {
+            ++m_BucketStart[GetBucket(cell) + 1];
+        }
+
+        for (size_t i = 0; i < buckets; ++i)
+        {
+            m_BucketStart[i + 1] += m_BucketStart[i];
+        }
+
+        m_EntryObjects.resize(entries);
+        m_EntryCells.resize(entries);
+
+        for (size_t i = 0; i < entries; ++i)
+        {
+            const auto target = m_BucketStart[GetBucket(m_UnsortedCells[i])]++;
+            m_EntryObjects[target] = m_UnsortedObjects[i];
+            m_EntryCells[target] = m_UnsortedCells[i];
+        }
+
+        //
+        // Scatter advanced each start to start of next bucket; shift them back.
+        //
+        for (size_t i = buckets; i > 0; --i)
+        {
+            m_BucketStart[i] = m_BucketStart[i - 1];
+        }
+
+        m_BucketStart[0] = 0;
+    }
+
+    SpatialGrid::CellRange SpatialGrid::GetCellRange(float minX, float minZ, float maxX, float maxZ) const noexcept
+    {
+        const auto toCell = [this](float value) noexcept
+        {
+            const auto cell = std::floor(value * m_InverseCellSize);
+            return static_cast<int32_t>((std::max)(-CellLimit, (std::min)(CellLimit, cell)));
+        };
+
+        return CellRange{ toCell(minX), toCell(minZ), toCell(maxX), toCell(maxZ) };
+    }
+
+    uint32_t SpatialGrid::GetBucket(uint64_t cell) const noexcept
+    {
+        //
+        // Fibonacci hashing; top bits of product are well mixed.
+        //
+        return static_cast<uint32_t>((cell * UINT64_C(0x9E3779B97F4A7C15)) >> m_BucketShift);
+    }
+
+    template <typename TFunction>
+    void SpatialGrid::ForEachCandidate(const CellRange& range, TFunction&& function) const noexcept
+    {
+        const auto cells = static_cast<uint64_t>(int64_t{ range.MaxX } - range.MinX + 1) * static_cast<uint64_t>(int64_t{ range.MaxZ } - range.MinZ + 1);
+
+        if (cells > m_IDs.size())
+        {
+            //
+            // Query covers more cells than there are objects; testing objects directly is cheaper.
+            //
+            for (uint32_t slot = 0; slot < static_cast<uint32_t>(m_IDs.size()); ++slot)
+            {
+                const auto& bounds = m_Cells[slot];
+
+                if (bounds.MinX <= range.MaxX && bounds.MaxX >= range.MinX && bounds.MinZ <= range.MaxZ && bounds.MaxZ >= range.MinZ)
+                {
+                    function(slot);
+                }
+            }
+
+            return;
+        }
+
+        for (auto z = range.MinZ; z <= range.MaxZ; ++z)
+        {
+            for (auto x = range.MinX; x <= range.MaxX; ++x)
+            {
+                const auto cell = MakeCellKey(x, z);
+                const auto bucket = GetBucket(cell);
+
+                for (auto entry = m_BucketStart[bucket]; entry < m_BucketStart[bucket + 1]; ++entry)
+                {
+                    if (m_EntryCells[entry] != cell)
+                    {
+                        //
+                        // Other cell hashed to the same bucket.
+                        //
+                        continue;
+                    }
+
+                    const auto slot = m_EntryObjects[entry];
+                    const auto& bounds = m_Cells[slot];
+
+                    //
+                    // Object spanning multiple cells is reported only from first cell it shares
+                    // with query.
+                    //
+                    if (x == (std::max)(bounds.MinX, range.MinX) && z == (std::max)(bounds.MinZ, range.MinZ))
+                    {
+                        function(slot);
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename TQuery, typename TFunction>
+    void SpatialGrid::RunQueries(const TQuery* queries, size_t count, SpatialQueryResults& results, TFunction&& function) const noexcept
+    {
+        const auto chunks = (count + QueryGrainSize - 1) / QueryGrainSize;
+
+        if (results.m_Chunks.size() < chunks)
+        {
+            results.m_Chunks.resize(chunks);
+        }
+
+        results.Offsets.resize(count + 1);
+        results.Offsets[0] = 0;
+
+        Jobs::ParallelChunks(count, QueryGrainSize, [&](size_t chunk, size_t begin, size_t end)
+        {
+            auto& hits = results.m_Chunks[chunk];
+            hits.clear();
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto before = hits.size();
+                function(queries[i], hits);
+                results.Offsets[i + 1] = static_cast<uint32_t>(hits.size() - before);
+            }
+        });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            results.Offsets[i + 1] += results.Offsets[i];
+        }
+
+        results.Objects.clear();
+        results.Objects.reserve(results.Offsets[count]);
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            results.Objects.insert(std::end(results.Objects), std::begin(results.m_Chunks[chunk]), std::end(results.m_Chunks[chunk]));
+        }
+    }
+
+    void SpatialGrid::QueryRadius(const RadiusQuery* queries, size_t count, SpatialQueryResults& results) const noexcept
+    {
+        RunQueries(queries, count, results, [this](const RadiusQuery& query, std::vector<GameObjectID>& hits)
+        {
+            const auto x = query.Center.x;
+            const auto z = query.Center.z;
+            const auto radius = query.Radius;
+
+            ForEachCandidate(GetCellRange(x - radius, z - radius, x + radius, z + radius), [&](uint32_t slot)
+            {
+                if ((m_LayerBits[slot] & query.LayerMask) == 0)
+                {
+                    return;
+                }
+
+                const auto dx = m_CenterX[slot] - x;
+                const auto dz = m_CenterZ[slot] - z;
+                const auto reach = radius + m_Radius[slot];
+
+                if ((dx * dx + dz * dz) <= (reach * reach))
+                {
+                    hits.push_back(m_IDs[slot]);
+                }
+            });
+        });
+    }
+
+    void SpatialGrid::QueryBounds(const BoundsQuery* queries, size_t count, SpatialQueryResults& results) const noexcept
+    {
+        RunQueries(queries, count, results, [this](const BoundsQuery& query, std::vector<GameObjectID>& hits)
+        {
+            ForEachCandidate(GetCellRange(query.Min.x, query.Min.z, query.Max.x, query.Max.z), [&](uint32_t slot)
+            {
+                if ((m_LayerBits[slot] & query.LayerMask) == 0)
+                {
+                    return;
+                }
+
+                //
+                // Distance from center to closest point of box.
+                //
+                const auto dx = m_CenterX[slot] - (std::max)(query.Min.x, (std::min)(query.Max.x, m_CenterX[slot]));
+                const auto dz = m_CenterZ[slot] - (std::max)(query.Min.z, (std::min)(query.Max.z, m_CenterZ[slot]));
+
+                if ((dx * dx + dz * dz) <= (m_Radius[slot] * m_Radius[slot]))
+                {
+                    hits.push_back(m_IDs[slot]);
+                }
+            });
+        });
+    }
+
+    void SpatialGrid::CastRays(const RayQuery* queries, size_t count, RayHit* hits) const noexcept
+    {
+        Jobs::ParallelFor(count, QueryGrainSize, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                hits[i] = CastRay(queries[i]);
+            }
+        });
+    }
+
+    RayHit SpatialGrid::CastRay(const RayQuery& query) const noexcept
+    {
+        CORE_ASSERT(std::isfinite(query.MaxDistance));
+
+        RayHit result{ InvalidGameObjectID, query.MaxDistance };
+
+        const auto length = std::sqrt(query.Direction.x * query.Direction.x + query.Direction.z * query.Direction.z);
+
+        if (length <= 0.0F || m_IDs.empty())
+        {
+            return result;
+        }
+
+        const auto originX = query.Origin.x;
+        const auto originZ = query.Origin.z;
+        const auto directionX = query.Direction.x / length;
+        const auto directionZ = query.Direction.z / length;
+        const auto infinity = std::numeric_limits<float>::infinity();
+
+        //
+        // Walk cells pierced by ray in order (Amanatides-Woo traversal).
+        //
+        const auto start = GetCellRange(originX, originZ, originX, originZ);
+        auto cellX = start.MinX;
+        auto cellZ = start.MinZ;
+
+        const int32_t stepX = (directionX >= 0.0F) ? 1 : -1;
+        const int32_t stepZ = (directionZ >= 0.0F) ? 1 : -1;
+
+        const auto deltaX = (directionX != 0.0F) ? (m_CellSize / std::abs(directionX)) : infinity;
+        const auto deltaZ = (directionZ != 0.0F) ? (m_CellSize / std::abs(directionZ)) : infinity;
+
+        auto exitX = (directionX != 0.0F) ? ((static_cast<float>(cellX + (stepX > 0 ? 1 : 0)) * m_CellSize - originX) / directionX) : infinity;
+        auto exitZ = (directionZ != 0.0F) ? ((static_cast<float>(cellZ + (stepZ > 0 ? 1 : 0)) * m_CellSize - originZ) / directionZ) : infinity;
+
+        for (;;)
+        {
+            const auto cell = MakeCellKey(cellX, cellZ);
+            const auto bucket = GetBucket(cell);
+
+            for (auto entry = m_BucketStart[bucket]; entry < m_BucketStart[bucket + 1]; ++entry)
+            {
+                const auto slot = m_EntryObjects[entry];
+
+                if (m_EntryCells[entry] != cell || (m_LayerBits[slot] & query.LayerMask) == 0)
+                {
+                    continue;
+                }
+
+                //
+                // Ray against bounding circle. Origin inside circle hits at zero distance.
+                //
+                const auto offsetX = originX - m_CenterX[slot];
+                const auto offsetZ = originZ - m_CenterZ[slot];
+                const auto b = offsetX * directionX + offsetZ * directionZ;
+                const auto c = offsetX * offsetX + offsetZ * offsetZ - m_Radius[slot] * m_Radius[slot];
+
+                if (c > 0.0F && b > 0.0F)
+                {
+                    continue;
+                }
+
+                const auto discriminant = b * b - c;
+
+                if (discriminant < 0.0F)
+                {
+                    continue;
+                }
+
+                const auto distance = (std::max)(0.0F, -b - std::sqrt(discriminant));
+
+                if (distance < result.Distance || (distance == result.Distance && result.Object == InvalidGameObjectID))
+                {
+                    result.Object = m_IDs[slot];
+                    result.Distance = distance;
+                }
+            }
+
+            //
+            // Objects are stored in all cells they overlap, so nothing in further cells may be
+            // closer than hit found before leaving current one.
+            //
+            const auto exit = (std::min)(exitX, exitZ);
+
+            if (exit >= result.Distance)
+            {
+                break;
+            }
+
+            if (exitX < exitZ)
+            {
+                cellX += stepX;
+                exitX += deltaX;
+            }
+            else
+            {
+                cellZ += stepZ;
+                exitZ += deltaZ;
+            }
+        }
+
+        return result;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core.World/TimingWheel.hxx>
+#include <algorithm>
+
+namespace Core::World
+{
+    TimingWheel::TimingWheel() noexcept
+        : m_Slots{}
+        , m_Cascade{}
+        , m_CurrentTick{ 0 }
+        , m_Count{ 0 }
+    {
+    }
+
+    void TimingWheel::Schedule(GameObjectID object, uint32_t generation, uint64_t delay) noexcept
+    {
+        Insert(Timer{ m_CurrentTick + (std::max)(delay, uint64_t{ 1 }), object, generation });
+        ++m_Count;
+    }
+
+    void TimingWheel::Insert(const Timer& timer) noexcept
+    {
+        //
+        // Timers beyond horizon wait in farthest slot of top level.
+        //
+        const auto distance = (std::min)(timer.Expiry - m_CurrentTick, Horizon - 1);
+        const auto expiry = m_CurrentTick + distance;
+
+        uint32_t level = 0;
+
+        while (level + 1 < LevelCount && distance >= (uint64_t{ 1 } << (LevelBits * (level + 1))))
+        {
+            ++level;
+        }
+
+        const auto slot = static_cast<uint32_t>(expiry >> (LevelBits * level)) & (SlotsPerLevel - 1);
+        m_Slots[level][slot].push_back(timer);
+    }
+
+    void TimingWheel::Advance(std::vector<Timer>& expired) noexcept
+    {
+        ++m_CurrentTick;
+
+        //
+        // Cascade higher levels whose slot boundary was just crossed, top down, so timers may fall
+        // through several levels in single tick.
+        //
+        uint32_t top = 0;
+
+        while (top + 1 < LevelCount && ((m_CurrentTick >> (LevelBits * (top + 1) - LevelBits)) & (SlotsPerLevel - 1)) == 0)
+        {
+            ++top;
+        }
+
+        for (auto level = top; level > 0; --level)
+        {
+            const auto slot = static_cast<uint32_t>(m_CurrentTick >> (LevelBits * level)) & (SlotsPerLevel - 1);
+
+            m_Cascade.swap(m_Slots[level][slot]);
+
+            for (const auto& timer : m_Cascade)
+            {
+                Insert(timer);
+            }
+
+            m_Cascade.clear();
+        }
+
+        //
+        // Fire current slot of level 0.
+        //
+        auto& current = m_Slots[0][static_cast<uint32_t>(m_CurrentTick) & (SlotsPerLevel - 1)];
+
+        expired.insert(expired.end(), current.begin(), current.end());
+
+        m_Count -= current.size();
+        current.clear();
+    }
+
+    void TimingWheel::Clear() noexcept
+    {
+        for (auto& level : m_Slots)
+        {
+            for (auto& slot : level)
+            {
+                slot.clear();
+            }
+        }
+
+        m_Count = 0;
+    }
+}
\ No newline at end of file
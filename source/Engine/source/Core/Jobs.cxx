@@ -0,0 +1,458 @@
+//
+// Copyright (C) Selmentdev, 2017
+//
+//      See LICENSE file in the project root for full license information.
+//
+
+#include <Core/Jobs.hxx>
+#include <Core.Diagnostics/Debug.hxx>
+#include <Core.Diagnostics/Trace.hxx>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace Core
+{
+    namespace
+    {
+        //
+        // Number of jobs which may be alive per worker at once.
+        //
+        constexpr const size_t MaxJobsPerWorker = 4096;
+        constexpr const size_t JobsMask = MaxJobsPerWorker - 1;
+        static_assert((MaxJobsPerWorker & JobsMask) == 0, "Must be power of two");
+
+        //
+        // Upper bound of chunks scheduled by single parallel for. All of them are allocated and
+        // queued by calling worker, so it's kept well below its capacity.
+        //
+        constexpr const size_t ChunksPerWorker = 16;
+        constexpr const size_t MaxChunksPerCall = MaxJobsPerWorker / 4;
+
+        //
+        // Chase-Lev work stealing queue.
+        //
+        class JobQueue final
+        {
+        private:
+            std::atomic<int64_t> m_Bottom;
+            std::atomic<int64_t> m_Top;
+            std::atomic<Job*> m_Jobs[MaxJobsPerWorker];
+
+        public:
+            JobQueue() noexcept
+                : m_Bottom{ 0 }
+                , m_Top{ 0 }
+            {
+            }
+
+        public:
+            //
+            // Called only by owner.
+            //
+            void Push(Job* job) noexcept
+            {
+                const auto bottom = m_Bottom.load(std::memory_order_relaxed);
+
+                CORE_ASSERT(bottom - m_Top.load(std::memory_order_relaxed) < static_cast<int64_t>(MaxJobsPerWorker));
+
+                m_Jobs[bottom & JobsMask].store(job, std::memory_order_relaxed);
+                m_Bottom.store(bottom + 1, std::memory_order_release);
+            }
+
+            //
+            // Called only by owner.
+            //
+            Job* Pop() noexcept
+            {
+                const auto bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+                m_Bottom.store(bottom, std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                auto top = m_Top.load(std::memory_order_relaxed);
+
+                if (top > bottom)
+                {
+                    //
+                    // Queue is empty.
+                    //
+                    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                auto job = m_Jobs[bottom & JobsMask].load(std::memory_order_relaxed);
+
+                if (top != bottom)
+                {
+                    //
+                    // More than one job left, no race with stealers.
+                    //
+                    return job;
+                }
+
+                //
+                // Last job in queue; race against stealers.
+                //
+                if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    job = nullptr;
+                }
+
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                return job;
+            }
+
+            //
+            // Called by other workers.
+            //
+            Job* Steal() noexcept
+            {
+                auto top = m_Top.load(std::memory_order_acquire);
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                const auto bottom = m_Bottom.load(std::memory_order_acquire);
+
+                if (top >= bottom)
+                {
+                    return nullptr;
+                }
+
+                auto job = m_Jobs[top & JobsMask].load(std::memory_order_relaxed);
+
+                if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    //
+                    // Lost race with another stealer or owner.
+                    //
+                    return nullptr;
+                }
+
+                return job;
+            }
+        };
+
+        struct alignas(64) Worker final
+        {
+            JobQueue Queue;
+            Job JobPool[MaxJobsPerWorker];
+            size_t AllocatedJobs;
+            uint32_t RandomState;
+        };
+
+        std::vector<std::unique_ptr<Worker>> g_Workers{};
+        std::vector<std::thread> g_Threads{};
+        std::atomic<bool> g_IsRunning{ false };
+
+        //
+        // Idle workers sleep on condition variable, so they don't burn cores when there is no work.
+        //
+        std::mutex g_WakeMutex{};
+        std::condition_variable g_WakeCondition{};
+        std::atomic<int32_t> g_PendingJobs{ 0 };
+        std::atomic<int32_t> g_SleepingWorkers{ 0 };
+
+        thread_local uint32_t t_WorkerIndex{ 0 };
+
+        Worker& GetCurrentWorker() noexcept
+        {
+            return *g_Workers[t_WorkerIndex];
+        }
+
+        Job* GetJob() noexcept
+        {
+            auto& worker = GetCurrentWorker();
+
+            if (auto job = worker.Queue.Pop())
+            {
+                return job;
+            }
+
+            //
+            // Own queue is empty; try to steal from random victim.
+            //
+            const auto count = static_cast<uint32_t>(g_Workers.size());
+
+            if (count > 1)
+            {
+                //
+                // Xorshift is good enough for victim selection.
+                //
+                auto state = worker.RandomState;
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                worker.RandomState = state;
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const auto victim = (state + i) % count;
+
+                    if (victim != t_WorkerIndex)
+                    {
+                        if (auto job = g_Workers[victim]->Queue.Steal())
+                        {
+                            return job;
+                        }
+                    }
+                }
+            }
+
+            return nullptr;
+        }
+
+        void Finish(Job* job) noexcept
+        {
+            const auto unfinished = job->UnfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) - 1;
+
+            if (unfinished == 0)
+            {
+                //
+                // Job and all its children are done. Schedule continuations.
+                //
+                const auto continuations = job->ContinuationCount.load(std::memory_order_acquire);
+
+                for (int32_t i = 0; i < continuations; ++i)
+                {
+                    Jobs::Run(job->Continuations[i]);
+                }
+
+                if (job->Parent != nullptr)
+                {
+                    Finish(job->Parent);
+                }
+            }
+        }
+
+        void Execute(Job* job) noexcept
+        {
+            g_PendingJobs.fetch_sub(1, std::memory_order_relaxed);
+
+            job->Function(job, job->Payload);
+
+            Finish(job);
+        }
+
+        void WorkerThread(uint32_t index) noexcept
+        {
+            t_WorkerIndex = index;
+
+            while (g_IsRunning.load(std::memory_order_acquire))
+            {
+                if (auto job = GetJob())
+                {
+                    Execute(job);
+                    continue;
+                }
+
+                //
+                // Nothing to do. Sleep until new jobs are scheduled.
+                //
+                std::unique_lock<std::mutex> lock{ g_WakeMutex };
+
+                g_SleepingWorkers.fetch_add(1);
+                g_WakeCondition.wait(lock, []()
+                {
+                    return g_PendingJobs.load() > 0 || !g_IsRunning.load();
+                });
+                g_SleepingWorkers.fetch_sub(1);
+            }
+        }
+    }
+
+    void Jobs::Initialize(uint32_t workerCount) noexcept
+    {
+        CORE_ASSERT(g_Workers.empty());
+
+        if (workerCount == 0)
+        {
+            workerCount = (std::max)(1U, std::thread::hardware_concurrency());
+        }
+
+        g_Workers.reserve(workerCount);
+
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            auto worker = std::make_unique<Worker>();
+            worker->AllocatedJobs = 0;
+            worker->RandomState = 0x9E3779B9U * (i + 1);
+            g_Workers.push_back(std::move(worker));
+        }
+
+        //
+        // Calling thread becomes worker 0.
+        //
+        t_WorkerIndex = 0;
+        g_IsRunning.store(true, std::memory_order_release);
+
+        for (uint32_t i = 1; i < workerCount; ++i)
+        {
+            g_Threads.emplace_back(WorkerThread, i);
+        }
+
+        CORE_TRACE_MESSAGE(Info, "[Jobs] Started %u workers", workerCount);
+    }
+
+    void Jobs::Shutdown() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock{ g_WakeMutex };
+            g_IsRunning.store(false, std::memory_order_release);
+        }
+
+        g_WakeCondition.notify_all();
+
+        for (auto& thread : g_Threads)
+        {
+            thread.join();
+        }
+
+        g_Threads.clear();
+        g_Workers.clear();
+
+        CORE_TRACE_MESSAGE(Info, "[Jobs] Stopped workers");
+    }
+
+    uint32_t Jobs::GetWorkerCount() noexcept
+    {
+        return static_cast<uint32_t>(g_Workers.size());
+    }
+
+    uint32_t Jobs::GetCurrentWorkerIndex() noexcept
+    {
+        return t_WorkerIndex;
+    }
+
+    Job* Jobs::Create(JobFunction function, Job* parent) noexcept
+    {
+        auto& worker = GetCurrentWorker();
+
+        //
+        // Ring buffer allocation. Job slot is reused after MaxJobsPerWorker allocations, so no more
+        // jobs than that may be alive at once on single worker.
+        //
+        auto job = &worker.JobPool[worker.AllocatedJobs++ & JobsMask];
+
+        CORE_ASSERT(function != nullptr);
+
+        job->Function = function;
+        job->Parent = parent;
+        job->UnfinishedJobs.store(1, std::memory_order_relaxed);
+        job->ContinuationCount.store(0, std::memory_order_relaxed);
+
+        if (parent != nullptr)
+        {
+            parent->UnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return job;
+    }
+
+    Job* Jobs::Create(JobFunction function, const void* data, size_t size, Job* parent) noexcept
+    {
+        CORE_ASSERT(size <= sizeof(Job::Payload));
+
+        auto job = Jobs::Create(function, parent);
+        std::memcpy(job->Payload, data, size);
+        return job;
+    }
+
+    void Jobs::AddContinuation(Job* job, Job* continuation) noexcept
+    {
+        const auto index = job->ContinuationCount.fetch_add(1, std::memory_order_relaxed);
+
+        CORE_ASSERT(index < static_cast<int32_t>(Job::MaxContinuations));
+
+        job->Continuations[index] = continuation;
+    }
+
+    void Jobs::Run(Job* job) noexcept
+    {
+        GetCurrentWorker().Queue.Push(job);
+
+        g_PendingJobs.fetch_add(1);
+
+        //
+        // Wake up sleeping worker. Taking the lock guarantees that worker which already checked
+        // for pending jobs is waiting on condition variable before it is notified.
+        //
+        if (g_SleepingWorkers.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock{ g_WakeMutex };
+            }
+
+            g_WakeCondition.notify_one();
+        }
+    }
+
+    void Jobs::Wait(const Job* job) noexcept
+    {
+        while (!Jobs::IsFinished(job))
+        {
+            if (auto next = GetJob())
+            {
+                Execute(next);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void Jobs::ParallelFor(size_t count, size_t grain, ParallelForFunction function, void* context) noexcept
+    {
+        CORE_ASSERT(grain > 0);
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (count <= grain || g_Workers.size() <= 1)
+        {
+            //
+            // Not worth scheduling.
+            //
+            function(context, 0, count);
+            return;
+        }
+
+        struct ParallelForData final
+        {
+            ParallelForFunction Function;
+            void* Context;
+            size_t Begin;
+            size_t End;
+        };
+
+        //
+        // Coarsen grain for large ranges. Chunk size stays multiple of grain, so chunk boundaries
+        // of requested grain are preserved.
+        //
+        const auto maxChunks = (std::min)(g_Workers.size() * ChunksPerWorker, MaxChunksPerCall);
+        const auto grainsPerChunk = (count + grain * maxChunks - 1) / (grain * maxChunks);
+        grain *= grainsPerChunk;
+
+        auto root = Jobs::Create([](Job*, const void*) {});
+
+        for (size_t begin = 0; begin < count; begin += grain)
+        {
+            const ParallelForData data{ function, context, begin, (std::min)(begin + grain, count) };
+
+            auto chunk = Jobs::Create([](Job*, const void* payload)
+            {
+                auto data = static_cast<const ParallelForData*>(payload);
+                data->Function(data->Context, data->Begin, data->End);
+            }, &data, sizeof(data), root);
+
+            Jobs::Run(chunk);
+        }
+
+        Jobs::Run(root);
+        Jobs::Wait(root);
+    }
+}
\ No newline at end of file